@@ -0,0 +1,170 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/// @file profiler.h
+/// @brief Счетчики производительности (perf_event_open) для именованных участков программы
+///
+/// ProfileScope снимает показания в конструкторе и деструкторе и добавляет разницу к участку
+/// с тем же именем: такты, инструкции, промахи L1d и последнего уровня кэша, ошибки предсказания
+/// переходов, процессорное и настенное время. Счетчики открываются один раз с inherit, поэтому
+/// потоки, созданные после первого участка, тоже учитываются (их значения прибавляются при
+/// завершении потока). Счетчик, который ядро не дает открыть (нет PMU в виртуальной машине,
+/// perf_event_paranoid), пропускается - в отчете "n/a", настенное время есть всегда.
+/// Отчет по всем участкам печатает print_profile_report().
+
+/// @brief Набор счетчиков процесса
+class Profiler {
+    public:
+        /// @brief Число счетчиков: cycles, instructions, L1d misses, LLC misses, branch misses, cpu time
+        static const int counter_count = 6;
+
+        /// @brief Показания счетчиков и часов в момент времени
+        struct Sample {
+            double values[counter_count] = {};
+            double wall_ns = 0;
+        };
+
+        static Profiler& instance() {
+            static Profiler profiler;
+            return profiler;
+        }
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        ~Profiler() {
+            for (int fd : fds) if (fd >= 0) close(fd);
+        }
+
+        /// @brief Открыт ли счетчик i
+        bool available(int i) const { return fds[i] >= 0; }
+
+        /// @brief Текущие показания (с поправкой на мультиплексирование счетчиков ядром)
+        Sample read() const {
+            Sample sample;
+            for (int i = 0; i < counter_count; i++) {
+                if (fds[i] < 0) continue;
+                uint64_t data[3] = {}; // значение, time_enabled, time_running
+                if (::read(fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0) continue;
+                sample.values[i] = double(data[0]) * data[1] / data[2];
+            }
+            sample.wall_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            return sample;
+        }
+
+        /// @brief Добавление разницы показаний к участку name
+        void record(const std::string& name, const Sample& begin, const Sample& end) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = index.find(name);
+            if (it == index.end()) {
+                it = index.emplace(name, regions.size()).first;
+                regions.push_back({name, 0, Sample()});
+            }
+            Region& region = regions[it->second];
+            region.calls++;
+            for (int i = 0; i < counter_count; i++) region.total.values[i] += end.values[i] - begin.values[i];
+            region.total.wall_ns += end.wall_ns - begin.wall_ns;
+        }
+
+        /// @brief Таблица по участкам в порядке первого появления
+        void report(std::ostream& out) const {
+            std::lock_guard<std::mutex> lock(mutex);
+            out << "\nПрофиль участков (perf_event_open)\n";
+            if (!available(0)) out << "Аппаратные счетчики недоступны (" << unavailable_reason << "), в отчете n/a\n";
+            out << std::left << std::setw(28) << "region" << std::right << std::setw(7) << "calls" << std::setw(12) << "wall ms"
+                << std::setw(12) << "cpu ms" << std::setw(16) << "cycles" << std::setw(16) << "instructions" << std::setw(7) << "IPC"
+                << std::setw(14) << "L1d misses" << std::setw(14) << "LLC misses" << std::setw(14) << "br misses" << "\n";
+            for (const Region& region : regions) {
+                const double* v = region.total.values;
+                out << std::left << std::setw(28) << region.name << std::right << std::setw(7) << region.calls
+                    << std::setw(12) << format(region.total.wall_ns / 1e6, true) << std::setw(12) << format(v[5] / 1e6, available(5))
+                    << std::setw(16) << format(v[0], available(0)) << std::setw(16) << format(v[1], available(1))
+                    << std::setw(7) << format(v[0] > 0 ? v[1] / v[0] : 0, available(0) && available(1))
+                    << std::setw(14) << format(v[2], available(2)) << std::setw(14) << format(v[3], available(3))
+                    << std::setw(14) << format(v[4], available(4)) << "\n";
+            }
+        }
+
+    private:
+        struct Region {
+            std::string name;
+            uint64_t calls;
+            Sample total;
+        };
+
+        int fds[counter_count];
+        std::string unavailable_reason;
+        mutable std::mutex mutex;
+        std::vector<Region> regions;
+        std::map<std::string, size_t> index;
+
+        Profiler() {
+            const struct { uint32_t type; uint64_t config; } events[counter_count] = {
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+                {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+            };
+            for (int i = 0; i < counter_count; i++) {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = events[i].type;
+                attr.config = events[i].config;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                attr.inherit = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                fds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+                if (fds[i] < 0 && unavailable_reason.empty()) unavailable_reason = std::strerror(errno);
+            }
+        }
+
+        static std::string format(double value, bool valid) {
+            if (!valid) return "n/a";
+            std::ostringstream text;
+            if (value >= 1e6) text << std::setprecision(4) << std::scientific << value;
+            else text << std::setprecision(2) << std::fixed << value;
+            return text.str();
+        }
+};
+
+/// @brief Участок программы: счетчики за время жизни объекта добавляются к участку name
+class ProfileScope {
+    public:
+        explicit ProfileScope(std::string name) : name(std::move(name)), begin(Profiler::instance().read()) {}
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+        ~ProfileScope() { finish(); }
+
+        /// @brief Закрыть участок раньше конца области видимости (объекты, построенные в нем, нужны дальше)
+        void finish() {
+            if (finished) return;
+            finished = true;
+            Profiler::instance().record(name, begin, Profiler::instance().read());
+        }
+
+    private:
+        std::string name;
+        Profiler::Sample begin;
+        bool finished = false;
+};
+
+/// @brief Отчет по всем участкам
+inline void print_profile_report(std::ostream& out = std::cout) { Profiler::instance().report(out); }
@@ -7,6 +7,7 @@
 #include <chrono> 
 #include "Player.h"
 #include "sort_algo.h"
+#include "../Common/profiler.h"
 #include <algorithm>
 
 /// @file start.cpp
@@ -73,27 +74,35 @@ int main() {
     for (std::string current_file_name : filenames) {
     //std::string current_file_name = "data_algo/output_players100.csv";
         std::string key_country = "Russia";
-        std::vector<Player> st = getPlayers(current_file_name);
+        std::vector<Player> st;
+        {
+            ProfileScope scope("load");
+            st = getPlayers(current_file_name);
+        }
         
         int N = st.size();
 
         auto start_time = std::chrono::high_resolution_clock::now();
-        // Сортировка слиянием
-        merge_sort(st, 0, N);
+        {
+            ProfileScope scope("sort n=" + std::to_string(N));
+            // Сортировка слиянием
+            merge_sort(st, 0, N);
         
-        //Быстрая ортировка
-        //quick_sort(st, 0, N);
+            //Быстрая ортировка
+            //quick_sort(st, 0, N);
         
-        //Пирамидальная сортировка
-        //heap_sort(st);
+            //Пирамидальная сортировка
+            //heap_sort(st);
         
-        //sort
-        //std::sort(st.begin(), st.end());
+            //sort
+            //std::sort(st.begin(), st.end());
+        }
         auto end_time = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double, std::milli> duration = end_time - start_time;
         std::cout << duration.count() << " ms\n";
 }
 
+    print_profile_report();
     return 0;
 };
 
@@ -0,0 +1,462 @@
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/// @file art.h
+/// @brief Адаптивное префиксное дерево (ART) по строковому полю игрока
+///
+/// Внутренние вершины четырех размеров (Node4/16/48/256) выбираются по числу потомков,
+/// цепочки вершин с одним потомком сжимаются в префикс вершины. Лист хранит полный ключ
+/// и номера строк в массиве игроков. Кроме точного поиска дерево поддерживает поиск по
+/// префиксу и обход ключей отрезка [lo, hi] в лексикографическом порядке.
+
+class ARTIndex {
+    public:
+        const std::vector<Player>& players;
+        /// @brief Индексируемое поле (country, name, club, position)
+        std::string Player::* field;
+
+        /// @param players Массив игроков, в который указывают номера строк
+        /// @param field Поле-ключ, по умолчанию страна
+        ARTIndex(const std::vector<Player>& players, std::string Player::* field = &Player::country)
+            : players(players), field(field) {}
+
+        ARTIndex(const ARTIndex&) = delete;
+        ARTIndex& operator=(const ARTIndex&) = delete;
+
+        ~ARTIndex() { destroy(root); }
+
+        /// @brief Вставка строки players[row]
+        void insert(uint32_t row) {
+            const std::string& key = players[row].*field;
+            insert(root, key, 0, row);
+        }
+
+        /// @brief Номера строк с ключом, равным key
+        std::vector<uint32_t> search(const std::string& key) const {
+            const Leaf* leaf = find(key);
+            return leaf ? leaf->rows : std::vector<uint32_t>();
+        }
+
+        /// @brief Обход ключей, начинающихся с prefix, в порядке возрастания
+        /// @param visit Вызывается как visit(key, rows)
+        template <class Visit>
+        void for_each_prefix(const std::string& prefix, Visit&& visit) const {
+            const Node* node = root;
+            size_t depth = 0;
+            while (node && depth < prefix.size()) {
+                if (node->type == leaf_node) {
+                    const Leaf* leaf = static_cast<const Leaf*>(node);
+                    if (leaf->key.compare(0, prefix.size(), prefix) == 0) visit(leaf->key, leaf->rows);
+                    return;
+                }
+                const Inner* inner = static_cast<const Inner*>(node);
+                size_t n = std::min(inner->prefix.size(), prefix.size() - depth);
+                if (inner->prefix.compare(0, n, prefix, depth, n) != 0) return;
+                depth += inner->prefix.size();
+                if (depth >= prefix.size()) break; // запрос закончился внутри префикса вершины
+                node = find_child(inner, static_cast<uint8_t>(prefix[depth]));
+                depth++;
+            }
+            if (node) for_each(node, visit);
+        }
+
+        /// @brief Обход ключей из отрезка [lo, hi] в порядке возрастания
+        /// @param visit Вызывается как visit(key, rows)
+        template <class Visit>
+        void for_each_range(const std::string& lo, const std::string& hi, Visit&& visit) const {
+            if (!(hi < lo)) {
+                std::string path;
+                for_each_range(root, path, lo, hi, visit);
+            }
+        }
+
+        /// @brief Номера строк с ключами, начинающимися с prefix (по возрастанию ключа)
+        std::vector<uint32_t> prefix(const std::string& prefix) const {
+            std::vector<uint32_t> result;
+            for_each_prefix(prefix, [&](const std::string&, const std::vector<uint32_t>& rows) {
+                result.insert(result.end(), rows.begin(), rows.end());
+            });
+            return result;
+        }
+
+        /// @brief Номера строк с ключами из отрезка [lo, hi] (по возрастанию ключа)
+        std::vector<uint32_t> range(const std::string& lo, const std::string& hi) const {
+            std::vector<uint32_t> result;
+            for_each_range(lo, hi, [&](const std::string&, const std::vector<uint32_t>& rows) {
+                result.insert(result.end(), rows.begin(), rows.end());
+            });
+            return result;
+        }
+
+        /// @brief Число различных ключей
+        size_t size() const { return key_count; }
+
+        /// @brief Память дерева в байтах (вершины, префиксы, ключи листьев и списки строк)
+        size_t memory_bytes() const { return sizeof(*this) + memory_bytes(root); }
+
+    private:
+        enum NodeType : uint8_t { leaf_node, node4, node16, node48, node256 };
+
+        struct Node {
+            NodeType type;
+        };
+
+        struct Leaf : Node {
+            std::string key;
+            std::vector<uint32_t> rows;
+        };
+
+        /// @brief Общая часть внутренних вершин
+        struct Inner : Node {
+            uint16_t count = 0;
+            /// @brief Сжатый путь: байты ключа между родителем и этой вершиной
+            std::string prefix;
+            /// @brief Лист для ключа, который заканчивается ровно в этой вершине
+            Leaf* terminal = nullptr;
+        };
+
+        /// @brief До 4 потомков, байты отсортированы
+        struct Node4 : Inner {
+            uint8_t keys[4];
+            Node* children[4];
+        };
+
+        /// @brief До 16 потомков, байты отсортированы, поиск одним сравнением SSE2
+        struct Node16 : Inner {
+            uint8_t keys[16];
+            Node* children[16];
+        };
+
+        /// @brief До 48 потомков: байт -> номер слота + 1 (0 - нет потомка)
+        struct Node48 : Inner {
+            uint8_t child_index[256];
+            Node* children[48];
+        };
+
+        /// @brief Прямая адресация потомка по байту
+        struct Node256 : Inner {
+            Node* children[256];
+        };
+
+        Node* root = nullptr;
+        size_t key_count = 0;
+
+        Leaf* make_leaf(const std::string& key, uint32_t row) {
+            Leaf* leaf = new Leaf();
+            leaf->type = leaf_node;
+            leaf->key = key;
+            leaf->rows.push_back(row);
+            key_count++;
+            return leaf;
+        }
+
+        template <class T>
+        static T* make_inner(NodeType type) {
+            T* node = new T();
+            node->type = type;
+            return node;
+        }
+
+        static void destroy(Node* node) {
+            if (!node) return;
+            if (node->type == leaf_node) {
+                delete static_cast<Leaf*>(node);
+                return;
+            }
+            Inner* inner = static_cast<Inner*>(node);
+            delete inner->terminal;
+            for_each_child(inner, [](uint8_t, Node* child) { destroy(child); });
+            switch (node->type) {
+                case node4: delete static_cast<Node4*>(node); break;
+                case node16: delete static_cast<Node16*>(node); break;
+                case node48: delete static_cast<Node48*>(node); break;
+                default: delete static_cast<Node256*>(node); break;
+            }
+        }
+
+        /// @brief Указатель на ячейку потомка по байту или nullptr
+        static Node* const* child_slot(const Inner* inner, uint8_t byte) {
+            switch (inner->type) {
+                case node4: {
+                    const Node4* n = static_cast<const Node4*>(inner);
+                    for (int i = 0; i < n->count; i++) if (n->keys[i] == byte) return &n->children[i];
+                    return nullptr;
+                }
+                case node16: {
+                    const Node16* n = static_cast<const Node16*>(inner);
+#ifdef __SSE2__
+                    __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(n->keys)));
+                    unsigned mask = _mm_movemask_epi8(cmp) & ((1u << n->count) - 1);
+                    return mask ? &n->children[__builtin_ctz(mask)] : nullptr;
+#else
+                    for (int i = 0; i < n->count; i++) if (n->keys[i] == byte) return &n->children[i];
+                    return nullptr;
+#endif
+                }
+                case node48: {
+                    const Node48* n = static_cast<const Node48*>(inner);
+                    return n->child_index[byte] ? &n->children[n->child_index[byte] - 1] : nullptr;
+                }
+                default: {
+                    const Node256* n = static_cast<const Node256*>(inner);
+                    return n->children[byte] ? &n->children[byte] : nullptr;
+                }
+            }
+        }
+
+        static Node* find_child(const Inner* inner, uint8_t byte) {
+            Node* const* slot = child_slot(inner, byte);
+            return slot ? *slot : nullptr;
+        }
+
+        /// @brief Обход потомков в порядке возрастания байта
+        template <class Visit>
+        static void for_each_child(const Inner* inner, Visit&& visit) {
+            switch (inner->type) {
+                case node4: {
+                    const Node4* n = static_cast<const Node4*>(inner);
+                    for (int i = 0; i < n->count; i++) visit(n->keys[i], n->children[i]);
+                    break;
+                }
+                case node16: {
+                    const Node16* n = static_cast<const Node16*>(inner);
+                    for (int i = 0; i < n->count; i++) visit(n->keys[i], n->children[i]);
+                    break;
+                }
+                case node48: {
+                    const Node48* n = static_cast<const Node48*>(inner);
+                    for (int b = 0; b < 256; b++) if (n->child_index[b]) visit(uint8_t(b), n->children[n->child_index[b] - 1]);
+                    break;
+                }
+                default: {
+                    const Node256* n = static_cast<const Node256*>(inner);
+                    for (int b = 0; b < 256; b++) if (n->children[b]) visit(uint8_t(b), n->children[b]);
+                    break;
+                }
+            }
+        }
+
+        /// @brief Копирование общей части при переходе к вершине большего размера
+        static void copy_header(Inner* to, const Inner* from) {
+            to->count = from->count;
+            to->prefix = from->prefix;
+            to->terminal = from->terminal;
+        }
+
+        /// @brief Добавление потомка; заполненная вершина заменяется следующей по размеру
+        static void add_child(Node*& ref, uint8_t byte, Node* child) {
+            Inner* inner = static_cast<Inner*>(ref);
+            switch (inner->type) {
+                case node4: {
+                    Node4* n = static_cast<Node4*>(inner);
+                    if (n->count < 4) {
+                        int i = n->count;
+                        for (; i > 0 && n->keys[i - 1] > byte; i--) {
+                            n->keys[i] = n->keys[i - 1];
+                            n->children[i] = n->children[i - 1];
+                        }
+                        n->keys[i] = byte;
+                        n->children[i] = child;
+                        n->count++;
+                        return;
+                    }
+                    Node16* bigger = make_inner<Node16>(node16);
+                    copy_header(bigger, n);
+                    std::memcpy(bigger->keys, n->keys, 4);
+                    std::memcpy(bigger->children, n->children, 4 * sizeof(Node*));
+                    delete n;
+                    ref = bigger;
+                    break;
+                }
+                case node16: {
+                    Node16* n = static_cast<Node16*>(inner);
+                    if (n->count < 16) {
+                        int i = n->count;
+                        for (; i > 0 && n->keys[i - 1] > byte; i--) {
+                            n->keys[i] = n->keys[i - 1];
+                            n->children[i] = n->children[i - 1];
+                        }
+                        n->keys[i] = byte;
+                        n->children[i] = child;
+                        n->count++;
+                        return;
+                    }
+                    Node48* bigger = make_inner<Node48>(node48);
+                    copy_header(bigger, n);
+                    for (int i = 0; i < 16; i++) {
+                        bigger->child_index[n->keys[i]] = uint8_t(i + 1);
+                        bigger->children[i] = n->children[i];
+                    }
+                    delete n;
+                    ref = bigger;
+                    break;
+                }
+                case node48: {
+                    Node48* n = static_cast<Node48*>(inner);
+                    if (n->count < 48) {
+                        n->children[n->count] = child;
+                        n->child_index[byte] = uint8_t(++n->count);
+                        return;
+                    }
+                    Node256* bigger = make_inner<Node256>(node256);
+                    copy_header(bigger, n);
+                    for (int b = 0; b < 256; b++) if (n->child_index[b]) bigger->children[b] = n->children[n->child_index[b] - 1];
+                    delete n;
+                    ref = bigger;
+                    break;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(inner);
+                    n->children[byte] = child;
+                    n->count++;
+                    return;
+                }
+            }
+            add_child(ref, byte, child); // вставка в выросшую вершину
+        }
+
+        /// @brief Подвешивает лист к вершине: как terminal, если ключ кончился, иначе как потомка
+        void attach(Node*& ref, const std::string& key, size_t depth, Leaf* leaf) {
+            if (depth == key.size()) static_cast<Inner*>(ref)->terminal = leaf;
+            else add_child(ref, static_cast<uint8_t>(key[depth]), leaf);
+        }
+
+        void insert(Node*& ref, const std::string& key, size_t depth, uint32_t row) {
+            if (!ref) {
+                ref = make_leaf(key, row);
+                return;
+            }
+
+            if (ref->type == leaf_node) {
+                Leaf* leaf = static_cast<Leaf*>(ref);
+                if (leaf->key == key) {
+                    leaf->rows.push_back(row);
+                    return;
+                }
+                // Два разных ключа: новая Node4 с общим продолжением в префиксе
+                size_t common = 0;
+                while (depth + common < key.size() && depth + common < leaf->key.size() && key[depth + common] == leaf->key[depth + common]) common++;
+                Node* split = make_inner<Node4>(node4);
+                static_cast<Inner*>(split)->prefix = key.substr(depth, common);
+                attach(split, leaf->key, depth + common, leaf);
+                attach(split, key, depth + common, make_leaf(key, row));
+                ref = split;
+                return;
+            }
+
+            Inner* inner = static_cast<Inner*>(ref);
+            size_t matched = 0;
+            while (matched < inner->prefix.size() && depth + matched < key.size() && inner->prefix[matched] == key[depth + matched]) matched++;
+            if (matched < inner->prefix.size()) {
+                // Ключ расходится с префиксом: вершина уходит вниз под новую Node4
+                Node* split = make_inner<Node4>(node4);
+                static_cast<Inner*>(split)->prefix = inner->prefix.substr(0, matched);
+                uint8_t byte = static_cast<uint8_t>(inner->prefix[matched]);
+                inner->prefix.erase(0, matched + 1);
+                add_child(split, byte, inner);
+                attach(split, key, depth + matched, make_leaf(key, row));
+                ref = split;
+                return;
+            }
+
+            depth += matched;
+            if (depth == key.size()) {
+                if (inner->terminal) inner->terminal->rows.push_back(row);
+                else inner->terminal = make_leaf(key, row);
+                return;
+            }
+            Node* const* slot = child_slot(inner, static_cast<uint8_t>(key[depth]));
+            if (slot) insert(const_cast<Node*&>(*slot), key, depth + 1, row);
+            else add_child(ref, static_cast<uint8_t>(key[depth]), make_leaf(key, row));
+        }
+
+        const Leaf* find(const std::string& key) const {
+            const Node* node = root;
+            size_t depth = 0;
+            while (node) {
+                if (node->type == leaf_node) {
+                    const Leaf* leaf = static_cast<const Leaf*>(node);
+                    return leaf->key == key ? leaf : nullptr;
+                }
+                const Inner* inner = static_cast<const Inner*>(node);
+                if (key.size() - depth < inner->prefix.size() || key.compare(depth, inner->prefix.size(), inner->prefix) != 0) return nullptr;
+                depth += inner->prefix.size();
+                if (depth == key.size()) return inner->terminal;
+                node = find_child(inner, static_cast<uint8_t>(key[depth]));
+                depth++;
+            }
+            return nullptr;
+        }
+
+        /// @brief Обход всех листьев поддерева по возрастанию ключа
+        template <class Visit>
+        static void for_each(const Node* node, Visit& visit) {
+            if (node->type == leaf_node) {
+                const Leaf* leaf = static_cast<const Leaf*>(node);
+                visit(leaf->key, leaf->rows);
+                return;
+            }
+            const Inner* inner = static_cast<const Inner*>(node);
+            if (inner->terminal) visit(inner->terminal->key, inner->terminal->rows); // ключ короче всех в поддереве
+            for_each_child(inner, [&](uint8_t, const Node* child) { for_each(child, visit); });
+        }
+
+        /// @brief Обход поддерева с общим началом ключей path с отсечением по [lo, hi]
+        template <class Visit>
+        static void for_each_range(const Node* node, std::string& path, const std::string& lo, const std::string& hi, Visit& visit) {
+            if (!node) return;
+            if (node->type == leaf_node) {
+                const Leaf* leaf = static_cast<const Leaf*>(node);
+                if (!(leaf->key < lo) && !(hi < leaf->key)) visit(leaf->key, leaf->rows);
+                return;
+            }
+            const Inner* inner = static_cast<const Inner*>(node);
+            size_t path_size = path.size();
+            path += inner->prefix;
+            // Все ключи поддерева >= path; если path > hi или path < lo и не является началом lo,
+            // поддерево целиком вне отрезка
+            bool above = hi < path;
+            bool below = path < lo && lo.compare(0, path.size(), path) != 0;
+            if (!above && !below) {
+                if (inner->terminal && !(inner->terminal->key < lo) && !(hi < inner->terminal->key))
+                    visit(inner->terminal->key, inner->terminal->rows);
+                for_each_child(inner, [&](uint8_t byte, const Node* child) {
+                    path.push_back(static_cast<char>(byte));
+                    for_each_range(child, path, lo, hi, visit);
+                    path.pop_back();
+                });
+            }
+            path.resize(path_size);
+        }
+
+        /// @brief Байты строки в куче (0 для коротких строк внутри объекта)
+        static size_t string_heap_bytes(const std::string& s) {
+            const char* inside = reinterpret_cast<const char*>(&s);
+            if (s.data() >= inside && s.data() < inside + sizeof(s)) return 0;
+            return s.capacity() + 1;
+        }
+
+        static size_t memory_bytes(const Node* node) {
+            if (!node) return 0;
+            if (node->type == leaf_node) {
+                const Leaf* leaf = static_cast<const Leaf*>(node);
+                return sizeof(Leaf) + string_heap_bytes(leaf->key) + leaf->rows.capacity() * sizeof(uint32_t);
+            }
+            const Inner* inner = static_cast<const Inner*>(node);
+            size_t result = string_heap_bytes(inner->prefix) + memory_bytes(inner->terminal);
+            switch (node->type) {
+                case node4: result += sizeof(Node4); break;
+                case node16: result += sizeof(Node16); break;
+                case node48: result += sizeof(Node48); break;
+                default: result += sizeof(Node256); break;
+            }
+            for_each_child(inner, [&](uint8_t, const Node* child) { result += memory_bytes(child); });
+            return result;
+        }
+};
@@ -0,0 +1,417 @@
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <map>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include "Player.h"
+#include "load_players.h"
+#include "search.h"
+#include "query.h"
+#include "disk_index.h"
+#include "compact_index.h"
+#include "bloom_filter.h"
+#include "concurrent_hash.h"
+#include "result_cache.h"
+#include "art.h"
+
+/// @file benchmark.cpp
+/// @brief Сравнение структур поиска: время построения, память на элемент и задержки поиска
+///
+/// Запуск: ./benchmark [--json] [файлы...]. По умолчанию проходит по всем файлам data_algo,
+/// результат (CSV или JSON) печатается в stdout. Каждый ответ сверяется с linear_search.
+
+/// @brief Счетчик памяти: все выделения через operator new проходят через эти функции
+namespace alloc_counter {
+    /// @brief Атомарный: структуры вроде ConcurrentHashTable выделяют память из нескольких потоков
+    std::atomic<size_t> live_bytes(0);
+
+    /// @brief Перед блоком хранится его размер (заголовок выровнен на align)
+    void* allocate(size_t size, size_t align) {
+        size_t header = std::max<size_t>(align, sizeof(size_t));
+        char* raw = static_cast<char*>(std::aligned_alloc(header, (size + 2 * header - 1) / header * header));
+        if (!raw) throw std::bad_alloc();
+        char* user = raw + header;
+        reinterpret_cast<size_t*>(user)[-1] = size;
+        reinterpret_cast<size_t*>(user)[-2] = header;
+        live_bytes += size;
+        return user;
+    }
+
+    void deallocate(void* ptr) {
+        if (!ptr) return;
+        char* user = static_cast<char*>(ptr);
+        live_bytes -= reinterpret_cast<size_t*>(user)[-1];
+        std::free(user - reinterpret_cast<size_t*>(user)[-2]);
+    }
+}
+
+void* operator new(size_t size) { return alloc_counter::allocate(size, 2 * sizeof(size_t)); }
+void* operator new[](size_t size) { return alloc_counter::allocate(size, 2 * sizeof(size_t)); }
+void* operator new(size_t size, std::align_val_t align) { return alloc_counter::allocate(size, std::max<size_t>(size_t(align), 2 * sizeof(size_t))); }
+void* operator new[](size_t size, std::align_val_t align) { return alloc_counter::allocate(size, std::max<size_t>(size_t(align), 2 * sizeof(size_t))); }
+void operator delete(void* ptr) noexcept { alloc_counter::deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { alloc_counter::deallocate(ptr); }
+void operator delete(void* ptr, size_t) noexcept { alloc_counter::deallocate(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { alloc_counter::deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { alloc_counter::deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { alloc_counter::deallocate(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { alloc_counter::deallocate(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { alloc_counter::deallocate(ptr); }
+
+/// @brief Одна строка результата
+struct BenchResult {
+    std::string file;
+    size_t rows;
+    std::string structure;
+    double build_ms;
+    double bytes_per_row;
+    std::string mix;
+    double p50_ns;
+    double p99_ns;
+    double mean_ns;
+    bool verified;
+};
+
+/// @brief Набор ключей для одного сценария поиска
+struct KeyMix {
+    std::string name;
+    std::vector<std::string> keys;
+};
+
+/// @brief Имена игроков из результата поиска (для сверки с linear_search)
+std::vector<std::string> result_names(const std::vector<Player>& result, const std::vector<Player>&) {
+    std::vector<std::string> names;
+    for (const Player& p : result) names.push_back(p.name);
+    return names;
+}
+
+std::vector<std::string> result_names(const std::vector<uint32_t>& rows, const std::vector<Player>& players) {
+    std::vector<std::string> names;
+    for (uint32_t row : rows) names.push_back(players[row].name);
+    return names;
+}
+
+/// @brief Компактная хэш-таблица с кэшем результатов (словарь и таблица живут вместе с кэшем)
+struct CachedCompactIndex {
+    CountryDictionary dictionary;
+    CompactHashTable table;
+    CachedIndex<CompactHashTable> cached;
+
+    CachedCompactIndex(const std::vector<Player>& players, size_t capacity)
+        : dictionary(players), table(players, dictionary, players.size() * 2), cached(table, capacity) {}
+};
+
+/// @brief Исходная хэш-таблица (копии игроков) с кэшем результатов
+struct CachedHashIndex {
+    HashTable table;
+    CachedIndex<HashTable> cached;
+
+    CachedHashIndex(size_t size, size_t capacity) : table(size), cached(table, capacity) {}
+};
+
+/// @brief Результат из кэша: номера строк или копии игроков
+template <class Rows>
+std::vector<std::string> result_names(const std::shared_ptr<const Rows>& rows, const std::vector<Player>& players) {
+    return result_names(*rows, players);
+}
+
+using MapRange = std::pair<std::multimap<std::string, Player>::const_iterator, std::multimap<std::string, Player>::const_iterator>;
+std::vector<std::string> result_names(const MapRange& range, const std::vector<Player>&) {
+    std::vector<std::string> names;
+    for (auto it = range.first; it != range.second; ++it) names.push_back(it->second.name);
+    return names;
+}
+
+using RowRange = std::pair<const uint32_t*, const uint32_t*>;
+std::vector<std::string> result_names(const RowRange& range, const std::vector<Player>& players) {
+    std::vector<std::string> names;
+    for (const uint32_t* it = range.first; it != range.second; ++it) names.push_back(players[*it].name);
+    return names;
+}
+
+/// @brief Процентиль (доля q от 0 до 1) массива задержек
+double percentile(std::vector<double> values, double q) {
+    if (values.empty()) return 0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(q * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+/// @brief Замер одной структуры: построение, память, задержки по всем сценариям и сверка
+/// @param build Строит структуру и возвращает ее в std::unique_ptr
+/// @param search Поиск по ключу в построенной структуре
+template <class Build, class Search>
+void run_structure(std::vector<BenchResult>& results, const std::string& file, const std::vector<Player>& players,
+                   const std::vector<KeyMix>& mixes, const std::string& structure, Build build, Search search) {
+    size_t bytes_before = alloc_counter::live_bytes;
+    auto start_time = std::chrono::steady_clock::now();
+    auto index = build();
+    auto end_time = std::chrono::steady_clock::now();
+    double build_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    double bytes_per_row = players.empty() ? 0 : double(alloc_counter::live_bytes - bytes_before) / players.size();
+
+    // Сверка с линейным поиском на всех различных ключах сценариев
+    bool verified = true;
+    std::vector<std::string> checked;
+    for (const KeyMix& mix : mixes) checked.insert(checked.end(), mix.keys.begin(), mix.keys.end());
+    std::sort(checked.begin(), checked.end());
+    checked.erase(std::unique(checked.begin(), checked.end()), checked.end());
+    for (const std::string& key : checked) {
+        std::vector<std::string> expected = result_names(linear_search(players, key), players);
+        std::vector<std::string> actual = result_names(search(*index, key), players);
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        if (expected != actual) {
+            verified = false;
+            std::cerr << structure << ": wrong result for key \"" << key << "\" in " << file << "\n";
+            break;
+        }
+    }
+
+    for (const KeyMix& mix : mixes) {
+        std::vector<double> latencies;
+        latencies.reserve(mix.keys.size());
+        double total = 0;
+        for (const std::string& key : mix.keys) {
+            auto t0 = std::chrono::steady_clock::now();
+            auto result = search(*index, key);
+            auto t1 = std::chrono::steady_clock::now();
+            asm volatile("" : : "g"(&result) : "memory"); // результат не должен быть выброшен оптимизатором
+            double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+            latencies.push_back(ns);
+            total += ns;
+        }
+        results.push_back({file, players.size(), structure, build_ms, bytes_per_row, mix.name,
+                           percentile(latencies, 0.5), percentile(latencies, 0.99),
+                           latencies.empty() ? 0 : total / latencies.size(), verified});
+    }
+}
+
+/// @brief Замер хэш-таблицы с заданными политиками; длины пробирования (вставка и поиск
+/// по каждой смеси ключей: среднее, 99-й перцентиль, максимум) печатаются в stderr
+template <class Table>
+void run_hash_table(std::vector<BenchResult>& results, const std::string& file, const std::vector<Player>& players,
+                    const std::vector<KeyMix>& mixes, const std::string& structure) {
+    run_structure(results, file, players, mixes, structure,
+        [&] {
+            auto ht = std::make_unique<Table>(players.size() * 2);
+            for (const auto& p : players) ht->insert(p);
+            return ht;
+        },
+        [](Table& ht, const std::string& key) { return ht.search_hash(key); });
+    Table probe_stats(players.size() * 2);
+    for (const auto& p : players) probe_stats.insert(p);
+    const ProbeHistogram& inserts = probe_stats.insert_probes;
+    std::cerr << file << ": " << structure << " insert probes mean " << inserts.mean() << ", p99 " << inserts.percentile(0.99)
+              << ", max " << inserts.max() << ", collisions " << probe_stats.collision_number;
+    for (const KeyMix& mix : mixes) {
+        ProbeHistogram searches;
+        for (const std::string& key : mix.keys) probe_stats.search_hash(key, &searches);
+        std::cerr << "; search " << mix.name << " mean " << searches.mean() << ", p99 " << searches.percentile(0.99) << ", max " << searches.max();
+    }
+    std::cerr << "\n";
+}
+
+/// @brief Сценарии поиска: попадания (равномерно), промахи и ключи по закону Ципфа
+std::vector<KeyMix> make_mixes(const std::vector<Player>& players, size_t queries, std::mt19937& gen) {
+    std::vector<std::string> countries;
+    for (const Player& p : players) countries.push_back(p.country);
+    std::sort(countries.begin(), countries.end());
+    countries.erase(std::unique(countries.begin(), countries.end()), countries.end());
+    std::shuffle(countries.begin(), countries.end(), gen); // ранг по Ципфу не связан с алфавитом
+
+    std::vector<KeyMix> mixes = {{"hit", {}}, {"miss", {}}, {"zipf", {}}};
+    if (countries.empty()) return mixes;
+
+    std::uniform_int_distribution<size_t> uniform(0, countries.size() - 1);
+    std::vector<double> weights;
+    for (size_t i = 0; i < countries.size(); i++) weights.push_back(1.0 / (i + 1));
+    std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+
+    for (size_t i = 0; i < queries; i++) {
+        mixes[0].keys.push_back(countries[uniform(gen)]);
+        mixes[1].keys.push_back(countries[uniform(gen)] + " (missing)");
+        mixes[2].keys.push_back(countries[zipf(gen)]);
+    }
+    return mixes;
+}
+
+void print_csv(const std::vector<BenchResult>& results) {
+    std::cout << "file,rows,structure,build_ms,bytes_per_row,mix,p50_ns,p99_ns,mean_ns,verified\n";
+    for (const BenchResult& r : results)
+        std::cout << r.file << ',' << r.rows << ',' << r.structure << ',' << r.build_ms << ',' << r.bytes_per_row << ','
+                  << r.mix << ',' << r.p50_ns << ',' << r.p99_ns << ',' << r.mean_ns << ',' << (r.verified ? "yes" : "no") << "\n";
+}
+
+void print_json(const std::vector<BenchResult>& results) {
+    std::cout << "[\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        std::cout << "  {\"file\": \"" << r.file << "\", \"rows\": " << r.rows << ", \"structure\": \"" << r.structure
+                  << "\", \"build_ms\": " << r.build_ms << ", \"bytes_per_row\": " << r.bytes_per_row
+                  << ", \"mix\": \"" << r.mix << "\", \"p50_ns\": " << r.p50_ns << ", \"p99_ns\": " << r.p99_ns
+                  << ", \"mean_ns\": " << r.mean_ns << ", \"verified\": " << (r.verified ? "true" : "false") << "}"
+                  << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    std::cout << "]\n";
+}
+
+int main(int argc, char** argv) {
+    bool json = false;
+    std::vector<std::string> filenames;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json") json = true;
+        else filenames.push_back(arg);
+    }
+    if (filenames.empty()) filenames = {
+        "data_algo/output_players100.csv",
+        "data_algo/output_players174.csv",
+        "data_algo/output_players305.csv",
+        "data_algo/output_players534.csv",
+        "data_algo/output_players935.csv",
+        "data_algo/output_players1635.csv",
+        "data_algo/output_players2859.csv",
+        "data_algo/output_players5000.csv",
+        "data_algo/output_players8743.csv",
+        "data_algo/output_players15289.csv",
+        "data_algo/output_players26736.csv",
+        "data_algo/output_players46753.csv",
+        "data_algo/output_players81756.csv",
+        "data_algo/output_players142965.csv",
+        "data_algo/output_players250000.csv",
+        // 600 строк одной страны: хэш-индексы не должны терять или повторять строки одного ключа
+        "data_algo/output_players_same_key.csv",
+    };
+
+    const size_t queries = 2000;
+    std::mt19937 gen(2024);
+    std::vector<BenchResult> results;
+    bool all_verified = true;
+
+    for (const std::string& file : filenames) {
+        std::vector<Player> st = getPlayers(file);
+        if (st.empty()) {
+            std::cerr << "skip " << file << ": no data\n";
+            continue;
+        }
+        std::vector<KeyMix> mixes = make_mixes(st, queries, gen);
+        size_t first = results.size();
+
+        run_structure(results, file, st, mixes, "linear_search",
+            [&] { return std::make_unique<int>(0); },
+            [&](int&, const std::string& key) { return linear_search(st, key); });
+
+        run_structure(results, file, st, mixes, "BinarySearchTree",
+            [&] { auto bst = std::make_unique<BinarySearchTree>(); for (const auto& p : st) bst->insert(p); return bst; },
+            [](BinarySearchTree& bst, const std::string& key) { return bst.find_elemets_by_key(key); });
+
+        run_structure(results, file, st, mixes, "RBTree",
+            [&] { auto rbt = std::make_unique<RBTree>(); for (const auto& p : st) rbt->insert(p); return rbt; },
+            [](RBTree& rbt, const std::string& key) { return rbt.RB_search(key); });
+
+        run_hash_table<HashTable>(results, file, st, mixes, "HashTable");
+        run_hash_table<BasicHashTable<WordHash, MaskReduce, LinearProbe>>(results, file, st, mixes, "HashTable<Word/Mask/Linear>");
+        run_hash_table<BasicHashTable<WordHash, LemireReduce, RobinHoodProbe>>(results, file, st, mixes, "HashTable<Word/Lemire/RobinHood>");
+        run_hash_table<BasicHashTable<Crc32Hash, MaskReduce, TriangularProbe>>(results, file, st, mixes, "HashTable<Crc32/Mask/Triangular>");
+        run_hash_table<BasicHashTable<Crc32Hash, MaskReduce, RobinHoodProbe>>(results, file, st, mixes, "HashTable<Crc32/Mask/RobinHood>");
+        run_hash_table<BasicHashTable<LegacyHash, LemireReduce, QuadraticProbe>>(results, file, st, mixes, "HashTable<Legacy/Lemire/Quadratic>");
+
+        run_structure(results, file, st, mixes, "ConcurrentHashTable",
+            [&] { auto ht = std::make_unique<ConcurrentHashTable>(st, st.size() * 2); ht->bulk_build(); return ht; },
+            [](ConcurrentHashTable& ht, const std::string& key) { return ht.search(key); });
+
+        run_structure(results, file, st, mixes, "ARTIndex",
+            [&] { auto art = std::make_unique<ARTIndex>(st); for (uint32_t row = 0; row < st.size(); row++) art->insert(row); return art; },
+            [](const ARTIndex& art, const std::string& key) { return art.search(key); });
+
+        run_structure(results, file, st, mixes, "std::multimap",
+            [&] { auto m = std::make_unique<std::multimap<std::string, Player>>(); for (const auto& p : st) m->insert({p.country, p}); return m; },
+            [](const std::multimap<std::string, Player>& m, const std::string& key) { return MapRange(m.equal_range(key)); });
+
+        run_structure(results, file, st, mixes, "PlayerIndex",
+            [&] { return std::make_unique<PlayerIndex>(st); },
+            [](PlayerIndex& idx, const std::string& key) { return idx.query({Predicate::equals(Column::country, key)}); });
+
+        // Память индекса на диске - страницы файла в кэше ОС, в куче остается только объект DiskIndex
+        run_structure(results, file, st, mixes, "DiskIndex",
+            [&] {
+                auto didx = std::make_unique<DiskIndex>();
+                std::string index_file = file + ".idx";
+                if (!write_disk_index(st, file, index_file) || !didx->open(index_file, file)) std::cerr << "DiskIndex: " << didx->error << "\n";
+                return didx;
+            },
+            [](DiskIndex& didx, const std::string& key) { return RowRange(didx.find(key)); });
+
+        // Каждый компактный индекс строит свой словарь стран, и память словаря учтена в этом индексе
+        run_structure(results, file, st, mixes, "CompactBST",
+            [&] {
+                auto dict = std::make_shared<CountryDictionary>(st);
+                auto idx = std::make_unique<std::pair<std::shared_ptr<CountryDictionary>, CompactBST>>(dict, CompactBST(st, *dict));
+                for (uint32_t row = 0; row < st.size(); row++) idx->second.insert(row);
+                return idx;
+            },
+            [](auto& idx, const std::string& key) { return idx.second.search(key); });
+
+        run_structure(results, file, st, mixes, "CompactRBTree",
+            [&] {
+                auto dict = std::make_shared<CountryDictionary>(st);
+                auto idx = std::make_unique<std::pair<std::shared_ptr<CountryDictionary>, CompactRBTree>>(dict, CompactRBTree(st, *dict));
+                for (uint32_t row = 0; row < st.size(); row++) idx->second.insert(row);
+                return idx;
+            },
+            [](auto& idx, const std::string& key) { return idx.second.search(key); });
+
+        run_structure(results, file, st, mixes, "CompactHashTable",
+            [&] {
+                auto dict = std::make_shared<CountryDictionary>(st);
+                auto idx = std::make_unique<std::pair<std::shared_ptr<CountryDictionary>, CompactHashTable>>(dict, CompactHashTable(st, *dict, st.size() * 2));
+                for (uint32_t row = 0; row < st.size(); row++) idx->second.insert(row);
+                return idx;
+            },
+            [](auto& idx, const std::string& key) { return idx.second.search(key); });
+
+        // Кэш на 64 страны перед компактной хэш-таблицей; повторные ключи смеси zipf отдаются из кэша
+        run_structure(results, file, st, mixes, "Cached+CompactHashTable",
+            [&] {
+                auto idx = std::make_unique<CachedCompactIndex>(st, 64);
+                for (uint32_t row = 0; row < st.size(); row++) idx->cached.insert(row);
+                return idx;
+            },
+            [](CachedCompactIndex& idx, const std::string& key) { return idx.cached.search(key); });
+
+        run_structure(results, file, st, mixes, "Cached+HashTable",
+            [&] {
+                auto idx = std::make_unique<CachedHashIndex>(st.size() * 2, 64);
+                for (const auto& p : st) idx->cached.insert(p);
+                return idx;
+            },
+            [](CachedHashIndex& idx, const std::string& key) { return idx.cached.search(key); });
+
+        run_structure(results, file, st, mixes, "Bloom+HashTable",
+            [&] {
+                auto idx = std::make_unique<std::pair<BloomFilter, HashTable>>(BloomFilter(st, 0.01), HashTable(st.size() * 2));
+                for (const auto& p : st) idx->second.insert(p);
+                return idx;
+            },
+            [](auto& idx, const std::string& key) {
+                return bloom_guarded(idx.first, key, [&](const std::string& k) { return idx.second.search_hash(k); });
+            });
+
+        BloomFilter bloom(st, 0.01);
+        std::cerr << file << ": bloom filter FPR expected " << bloom.expected_fpr
+                  << ", measured " << bloom_false_positive_rate(bloom, st) << "\n";
+
+        for (size_t i = first; i < results.size(); i++) all_verified = all_verified && results[i].verified;
+    }
+
+    if (json) print_json(results);
+    else print_csv(results);
+    return all_verified ? 0 : 1;
+}
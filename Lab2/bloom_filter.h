@@ -0,0 +1,180 @@
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/// @file bloom_filter.h
+/// @brief Блочный фильтр Блума для быстрого отсечения стран, которых нет в данных
+///
+/// Каждый ключ попадает ровно в один блок размером с кэш-линию (16 слов по 32 бита)
+/// и выставляет по одному биту в первых k словах блока. Проверка - одно обращение
+/// к памяти и сравнение 16 слов (два AVX2-регистра).
+
+/// @brief 64-битный хэш строки, читает по 8 байт за шаг
+uint64_t string_hash64(const std::string& key) {
+    const uint64_t mul = 0x9E3779B97F4A7C15ull;
+    uint64_t hash = key.size() * mul;
+    size_t i = 0;
+    for (; i + 8 <= key.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, key.data() + i, 8);
+        hash = (hash ^ word) * mul;
+        hash ^= hash >> 29;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, key.data() + i, key.size() - i);
+    hash = (hash ^ tail) * mul;
+    // Финальное перемешивание (fmix64 из MurmurHash3)
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/// @brief Блок фильтра размером с кэш-линию
+struct alignas(64) BloomBlock {
+    uint32_t words[16];
+};
+
+/// @brief Блочный фильтр Блума по стране игрока
+class BloomFilter {
+    public:
+        /// @brief Блоки фильтра
+        std::vector<BloomBlock> blocks;
+        /// @brief Число бит на ключ (k <= 16, по одному в каждом из первых k слов блока)
+        unsigned int hashes;
+        /// @brief Ожидаемая (расчетная) доля ложноположительных ответов
+        double expected_fpr;
+
+        /// @brief Построение фильтра по странам игроков
+        /// @param players Данные
+        /// @param fpr Допустимая доля ложноположительных ответов
+        BloomFilter(const std::vector<Player>& players, double fpr = 0.01) {
+            std::unordered_set<std::string> countries;
+            for (const Player& p : players) countries.insert(p.country);
+            choose_size(countries.size(), fpr);
+            for (const std::string& country : countries) insert(country);
+        }
+
+        /// @brief Добавление ключа
+        void insert(const std::string& key) {
+            uint64_t hash = string_hash64(key);
+            BloomBlock& block = blocks[block_index(hash)];
+            for (unsigned int i = 0; i < hashes; i++) block.words[i] |= bit_mask(uint32_t(hash), i);
+        }
+
+        /// @brief False - ключа точно нет, True - ключ, возможно, есть
+        bool may_contain(const std::string& key) const {
+            uint64_t hash = string_hash64(key);
+            const BloomBlock& block = blocks[block_index(hash)];
+#ifdef __AVX2__
+            const __m256i h = _mm256_set1_epi32(uint32_t(hash));
+            const __m256i one = _mm256_set1_epi32(1);
+            for (int half = 0; half < 2; half++) {
+                __m256i salt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(salts + 8 * half));
+                __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(h, salt), 27);
+                __m256i mask = _mm256_and_si256(_mm256_sllv_epi32(one, bits), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(active + 8 * half)));
+                __m256i words = _mm256_load_si256(reinterpret_cast<const __m256i*>(block.words + 8 * half));
+                if (!_mm256_testc_si256(words, mask)) return false; // есть бит маски, которого нет в блоке
+            }
+            return true;
+#else
+            uint32_t missing = 0;
+            for (unsigned int i = 0; i < 16; i++) missing |= (bit_mask(uint32_t(hash), i) & active[i]) & ~block.words[i];
+            return missing == 0;
+#endif
+        }
+
+        size_t memory_bytes() const {
+            return sizeof(*this) + blocks.capacity() * sizeof(BloomBlock);
+        }
+
+    private:
+        /// @brief Нечетные множители для получения k независимых позиций бита из одного хэша
+        static constexpr uint32_t salts[16] = {
+            0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du, 0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u,
+            0x6a09e667u, 0xbb67ae85u, 0x3c6ef373u, 0xa54ff53bu, 0x510e527fu, 0x9b05688du, 0x1f83d9abu, 0x5be0cd19u};
+        /// @brief Маска используемых слов: ~0 для первых hashes слов, иначе 0
+        uint32_t active[16];
+
+        uint32_t block_index(uint64_t hash) const {
+            return static_cast<uint32_t>(((hash >> 32) * blocks.size()) >> 32);
+        }
+
+        static uint32_t bit_mask(uint32_t hash, unsigned int i) {
+            return 1u << ((hash * salts[i]) >> 27);
+        }
+
+        /// @brief Расчетная доля ложных срабатываний: число ключей в блоке распределено по Пуассону,
+        /// каждое из k слов блока заполнено как обычный фильтр Блума на 32 бита с одним хэшем
+        static double blocked_fpr(size_t keys, size_t block_count, unsigned int k) {
+            double lambda = double(keys) / block_count;
+            double probability = std::exp(-lambda); // P(в блоке j ключей), начиная с j = 0
+            double result = 0;
+            size_t limit = static_cast<size_t>(lambda + 10 * std::sqrt(lambda) + 20);
+            for (size_t j = 0; j <= limit; j++) {
+                result += probability * std::pow(1 - std::pow(1 - 1.0 / 32, double(j)), k);
+                probability *= lambda / (j + 1);
+            }
+            return result;
+        }
+
+        /// @brief Подбор минимального числа блоков и k, при которых расчетная доля не превышает fpr
+        void choose_size(size_t keys, double fpr) {
+            fpr = std::min(std::max(fpr, 1e-9), 0.5);
+            double bits_per_key = -std::log2(fpr) / std::log(2.0); // оценка для обычного фильтра
+            size_t block_count = std::max<size_t>(1, static_cast<size_t>(keys * bits_per_key / 512));
+            while (true) {
+                unsigned int best_k = 1;
+                double best = blocked_fpr(keys, block_count, 1);
+                for (unsigned int k = 2; k <= 16; k++) {
+                    double current = blocked_fpr(keys, block_count, k);
+                    if (current < best) {
+                        best = current;
+                        best_k = k;
+                    }
+                }
+                if (best <= fpr || keys == 0) {
+                    hashes = best_k;
+                    expected_fpr = best;
+                    break;
+                }
+                block_count += std::max<size_t>(1, block_count / 16);
+            }
+            blocks.assign(block_count, BloomBlock{});
+            for (unsigned int i = 0; i < 16; i++) active[i] = i < hashes ? ~0u : 0u;
+        }
+};
+
+/// @brief Поиск с отсечением по фильтру: при точном промахе индекс не вызывается
+/// @param filter Фильтр, построенный по тем же данным, что и индекс
+/// @param key Ключ поиска
+/// @param search Поиск в индексе, например [&](const std::string& k) { return ht.search_hash(k); }
+template <class Search>
+auto bloom_guarded(const BloomFilter& filter, const std::string& key, Search&& search) -> decltype(search(key)) {
+    if (!filter.may_contain(key)) return {};
+    return search(key);
+}
+
+/// @brief Измеренная доля ложноположительных ответов на ключах, которых точно нет в данных
+double bloom_false_positive_rate(const BloomFilter& filter, const std::vector<Player>& players, size_t probes = 100000) {
+    std::unordered_set<std::string> countries;
+    for (const Player& p : players) countries.insert(p.country);
+    size_t false_positives = 0;
+    size_t tested = 0;
+    for (size_t i = 0; tested < probes; i++) {
+        std::string key = "missing country " + std::to_string(i);
+        if (countries.count(key)) continue;
+        tested++;
+        if (filter.may_contain(key)) false_positives++;
+    }
+    return double(false_positives) / tested;
+}
@@ -0,0 +1,165 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "Player.h"
+#include "load_players.h"
+#include "protocol.h"
+
+/// @file client.cpp
+/// @brief Генератор нагрузки для server.cpp: пропускная способность и задержки запросов
+///
+/// Запуск: ./client [--socket путь] [--connections C] [--depth D] [--requests N]
+///                  [--dataset i] [--op lookup|count|range] [--keys файл.csv] [--miss доля]
+/// Каждое соединение обслуживает свой поток и держит до D неотвеченных запросов (конвейер).
+
+/// @brief Параметры нагрузки
+struct LoadConfig {
+    std::string socket_path = "/tmp/lab2_players.sock";
+    unsigned int connections = 4;
+    unsigned int depth = 32;
+    size_t requests = 100000;
+    uint8_t dataset = 3;
+    uint8_t op = op_lookup;
+    std::string keys_file = "data_algo/output_players46753.csv";
+    double miss_ratio = 0.1;
+};
+
+/// @brief Работа одного соединения
+/// @param latencies Задержки всех запросов соединения, мкс
+/// @return False - ошибка соединения или некорректный ответ
+bool run_connection(const LoadConfig& config, const std::vector<std::string>& keys, size_t requests,
+                    unsigned int seed, std::vector<double>& latencies) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, config.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::cerr << "cannot connect to " << config.socket_path << ": " << std::strerror(errno) << "\n";
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+    std::uniform_real_distribution<double> coin(0, 1);
+    using clock = std::chrono::steady_clock;
+    std::vector<clock::time_point> sent(requests);
+    latencies.reserve(requests);
+
+    size_t next_to_send = 0, received = 0;
+    std::vector<char> out, in;
+    char buffer[1 << 16];
+    while (received < requests) {
+        // Дополняем конвейер до depth неотвеченных запросов и отправляем одной записью
+        out.clear();
+        while (next_to_send < requests && next_to_send - received < config.depth) {
+            Request request;
+            request.id = static_cast<uint32_t>(next_to_send);
+            request.op = config.op;
+            request.dataset = config.dataset;
+            request.key = keys[pick(gen)];
+            if (coin(gen) < config.miss_ratio) request.key += " (missing)";
+            if (config.op == op_count_range) {
+                request.key2 = keys[pick(gen)];
+                if (request.key2 < request.key) std::swap(request.key, request.key2);
+            }
+            encode_request(request, out);
+            sent[next_to_send++] = clock::now();
+        }
+        size_t written = 0;
+        while (written < out.size()) {
+            ssize_t w = write(fd, out.data() + written, out.size() - written);
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0) {
+                close(fd);
+                return false;
+            }
+            written += w;
+        }
+
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            close(fd);
+            return false;
+        }
+        in.insert(in.end(), buffer, buffer + n);
+        size_t pos = 0;
+        while (size_t frame = complete_frame(in.data() + pos, in.size() - pos)) {
+            if (frame < 13) {
+                close(fd);
+                return false;
+            }
+            uint32_t id = get_u32(in.data() + pos + 4);
+            uint8_t status = static_cast<uint8_t>(in[pos + 8]);
+            if (id != received || status != status_ok) { // ответы приходят в порядке запросов
+                std::cerr << "unexpected response id " << id << " status " << int(status) << "\n";
+                close(fd);
+                return false;
+            }
+            latencies.push_back(std::chrono::duration<double, std::micro>(clock::now() - sent[id]).count());
+            received++;
+            pos += frame;
+        }
+        in.erase(in.begin(), in.begin() + pos);
+    }
+    close(fd);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    LoadConfig config;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i], value = argv[i + 1];
+        if (arg == "--socket") config.socket_path = value;
+        else if (arg == "--connections") config.connections = std::max(1, std::stoi(value));
+        else if (arg == "--depth") config.depth = std::max(1, std::stoi(value));
+        else if (arg == "--requests") config.requests = std::stoull(value);
+        else if (arg == "--dataset") config.dataset = static_cast<uint8_t>(std::stoi(value));
+        else if (arg == "--keys") config.keys_file = value;
+        else if (arg == "--miss") config.miss_ratio = std::stod(value);
+        else if (arg == "--op") config.op = value == "count" ? op_count : value == "range" ? op_count_range : op_lookup;
+        else {
+            std::cerr << "unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<std::string> keys;
+    for (const Player& p : getPlayers(config.keys_file)) keys.push_back(p.country);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    if (keys.empty()) {
+        std::cerr << "no keys in " << config.keys_file << "\n";
+        return 1;
+    }
+
+    std::vector<std::vector<double>> latencies(config.connections);
+    std::vector<char> ok(config.connections, 0);
+    std::vector<std::thread> threads;
+    auto start_time = std::chrono::steady_clock::now();
+    for (unsigned int c = 0; c < config.connections; c++) {
+        size_t share = config.requests / config.connections + (c < config.requests % config.connections ? 1 : 0);
+        threads.emplace_back([&, c, share] { ok[c] = run_connection(config, keys, share, 1000 + c, latencies[c]); });
+    }
+    for (std::thread& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    std::vector<double> all;
+    for (const auto& part : latencies) all.insert(all.end(), part.begin(), part.end());
+    std::sort(all.begin(), all.end());
+    auto pct = [&](double q) { return all.empty() ? 0.0 : all[std::min(all.size() - 1, static_cast<size_t>(q * all.size()))]; };
+
+    std::cout << "requests: " << all.size() << ", connections: " << config.connections << ", depth: " << config.depth << "\n";
+    std::cout << "throughput: " << all.size() / seconds << " req/s\n";
+    std::cout << "latency us: p50 " << pct(0.5) << ", p99 " << pct(0.99) << ", p99.9 " << pct(0.999) << ", max " << (all.empty() ? 0 : all.back()) << "\n";
+    return std::all_of(ok.begin(), ok.end(), [](char v) { return v; }) ? 0 : 1;
+}
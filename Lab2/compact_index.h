@@ -0,0 +1,367 @@
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+/// @file compact_index.h
+/// @brief Компактные индексы по стране: вершины хранят 32-битный id страны и номер строки
+/// в общем массиве игроков, а не копию Player. На пути поиска сравниваются только целые числа.
+
+/// @brief Отсутствующая вершина / неизвестная страна
+const uint32_t compact_none = UINT32_MAX;
+
+/// @brief Словарь стран: строка <-> 32-битный идентификатор
+class CountryDictionary {
+    public:
+        /// @brief Название страны по id
+        std::vector<std::string> names;
+        /// @brief id по названию страны
+        std::unordered_map<std::string, uint32_t> ids;
+
+        /// @brief Построение словаря; id выдаются в алфавитном порядке, поэтому
+        /// сравнение id совпадает со сравнением строк
+        CountryDictionary(const std::vector<Player>& players) {
+            for (const Player& p : players) ids.emplace(p.country, 0);
+            for (const auto& item : ids) names.push_back(item.first);
+            std::sort(names.begin(), names.end());
+            for (uint32_t id = 0; id < names.size(); id++) ids[names[id]] = id;
+        }
+
+        /// @brief id страны или compact_none, если такой страны нет
+        uint32_t find(const std::string& country) const {
+            auto it = ids.find(country);
+            return it == ids.end() ? compact_none : it->second;
+        }
+
+        /// @brief id страны; новая страна получает следующий свободный id (в конец порядка)
+        uint32_t intern(const std::string& country) {
+            auto it = ids.find(country);
+            if (it != ids.end()) return it->second;
+            names.push_back(country);
+            ids.emplace(country, static_cast<uint32_t>(names.size() - 1));
+            return static_cast<uint32_t>(names.size() - 1);
+        }
+
+        /// @brief Занимаемая словарем память в байтах (оценка)
+        size_t memory_bytes() const {
+            size_t result = sizeof(*this) + names.capacity() * sizeof(std::string);
+            for (const std::string& name : names) result += 2 * string_heap_bytes(name); // строка в names и ключ в ids
+            result += ids.bucket_count() * sizeof(void*) + ids.size() * (sizeof(std::pair<const std::string, uint32_t>) + sizeof(void*));
+            return result;
+        }
+
+        /// @brief Память строки вне самого объекта std::string (0 при small string optimization)
+        static size_t string_heap_bytes(const std::string& s) {
+            const char* inside = reinterpret_cast<const char*>(&s);
+            if (s.data() >= inside && s.data() < inside + sizeof(s)) return 0;
+            return s.capacity() + 1;
+        }
+};
+
+/// @brief Вершина компактного бинарного дерева поиска (16 байт)
+struct CompactBSTNode {
+    uint32_t key;
+    uint32_t row;
+    uint32_t left;
+    uint32_t right;
+};
+
+/// @brief Бинарное дерево поиска по id страны, вершины лежат в одном массиве
+class CompactBST {
+    public:
+        const std::vector<Player>& players;
+        CountryDictionary& dictionary;
+        std::vector<CompactBSTNode> nodes;
+        uint32_t root = compact_none;
+
+        CompactBST(const std::vector<Player>& players, CountryDictionary& dictionary) : players(players), dictionary(dictionary) {}
+
+        /// @brief Вставка строки row из общего массива игроков
+        void insert(uint32_t row) {
+            uint32_t key = dictionary.intern(players[row].country);
+            uint32_t index = static_cast<uint32_t>(nodes.size());
+            nodes.push_back({key, row, compact_none, compact_none});
+            if (root == compact_none) {
+                root = index;
+                return;
+            }
+            uint32_t node = root;
+            while (true) {
+                uint32_t& next = key < nodes[node].key ? nodes[node].left : nodes[node].right;
+                if (next == compact_none) {
+                    next = index;
+                    return;
+                }
+                node = next;
+            }
+        }
+
+        /// @brief Номера строк игроков из страны key
+        std::vector<uint32_t> search(const std::string& country) const {
+            std::vector<uint32_t> result;
+            uint32_t key = dictionary.find(country);
+            if (key == compact_none) return result;
+            uint32_t node = root;
+            while (node != compact_none) {
+                const CompactBSTNode& n = nodes[node];
+                if (n.key == key) {
+                    result.push_back(n.row);
+                    node = n.right; // равные ключи при вставке уходят направо
+                }
+                else node = key < n.key ? n.left : n.right;
+            }
+            return result;
+        }
+
+        size_t memory_bytes() const {
+            return sizeof(*this) + nodes.capacity() * sizeof(CompactBSTNode);
+        }
+};
+
+/// @brief Вершина компактного красно-черного дерева (24 байта)
+struct CompactRBNode {
+    uint32_t key;
+    uint32_t row;
+    uint32_t left;
+    uint32_t right;
+    uint32_t parent;
+    /// @brief True - красная вершина, False - черная
+    bool color;
+};
+
+/// @brief Красно-черное дерево по id страны, ссылки - индексы в массиве вершин
+class CompactRBTree {
+    public:
+        const std::vector<Player>& players;
+        CountryDictionary& dictionary;
+        std::vector<CompactRBNode> nodes;
+        uint32_t root = compact_none;
+
+        CompactRBTree(const std::vector<Player>& players, CountryDictionary& dictionary) : players(players), dictionary(dictionary) {}
+
+        /// @brief Вставка строки row из общего массива игроков
+        void insert(uint32_t row) {
+            uint32_t key = dictionary.intern(players[row].country);
+            uint32_t new_node = static_cast<uint32_t>(nodes.size());
+            uint32_t parent = compact_none;
+            uint32_t node = root;
+            while (node != compact_none) {
+                parent = node;
+                node = key < nodes[node].key ? nodes[node].left : nodes[node].right;
+            }
+            nodes.push_back({key, row, compact_none, compact_none, parent, true});
+            if (parent == compact_none) root = new_node;
+            else if (key < nodes[parent].key) nodes[parent].left = new_node;
+            else nodes[parent].right = new_node;
+            fix_insert(new_node);
+        }
+
+        /// @brief Номера строк игроков из страны key
+        std::vector<uint32_t> search(const std::string& country) const {
+            std::vector<uint32_t> result;
+            uint32_t key = dictionary.find(country);
+            if (key != compact_none) dfs_search(root, key, result);
+            return result;
+        }
+
+        size_t memory_bytes() const {
+            return sizeof(*this) + nodes.capacity() * sizeof(CompactRBNode);
+        }
+
+    private:
+        void dfs_search(uint32_t node, uint32_t key, std::vector<uint32_t>& result) const {
+            while (node != compact_none) {
+                const CompactRBNode& n = nodes[node];
+                if (n.key == key) { // после поворотов равные ключи могут оказаться с обеих сторон
+                    result.push_back(n.row);
+                    dfs_search(n.left, key, result);
+                    node = n.right;
+                }
+                else node = key < n.key ? n.left : n.right;
+            }
+        }
+
+        void rotate_left(uint32_t node) {
+            uint32_t son = nodes[node].right;
+            nodes[node].right = nodes[son].left;
+            if (nodes[son].left != compact_none) nodes[nodes[son].left].parent = node;
+            nodes[son].parent = nodes[node].parent;
+            uint32_t parent = nodes[node].parent;
+            if (parent == compact_none) root = son;
+            else if (nodes[parent].left == node) nodes[parent].left = son;
+            else nodes[parent].right = son;
+            nodes[son].left = node;
+            nodes[node].parent = son;
+        }
+
+        void rotate_right(uint32_t node) {
+            uint32_t son = nodes[node].left;
+            nodes[node].left = nodes[son].right;
+            if (nodes[son].right != compact_none) nodes[nodes[son].right].parent = node;
+            nodes[son].parent = nodes[node].parent;
+            uint32_t parent = nodes[node].parent;
+            if (parent == compact_none) root = son;
+            else if (nodes[parent].left == node) nodes[parent].left = son;
+            else nodes[parent].right = son;
+            nodes[son].right = node;
+            nodes[node].parent = son;
+        }
+
+        bool is_red(uint32_t node) const { return node != compact_none && nodes[node].color; }
+
+        void fix_insert(uint32_t node) {
+            while (node != root && nodes[nodes[node].parent].color) {
+                uint32_t parent = nodes[node].parent;
+                uint32_t grandparent = nodes[parent].parent;
+                bool parent_is_left = nodes[grandparent].left == parent;
+                uint32_t uncle = parent_is_left ? nodes[grandparent].right : nodes[grandparent].left;
+                if (is_red(uncle)) {
+                    nodes[parent].color = false;
+                    nodes[uncle].color = false;
+                    nodes[grandparent].color = true;
+                    node = grandparent;
+                    continue;
+                }
+                if (parent_is_left) {
+                    if (node == nodes[parent].right) {
+                        node = parent;
+                        rotate_left(node);
+                    }
+                    nodes[nodes[node].parent].color = false;
+                    nodes[grandparent].color = true;
+                    rotate_right(grandparent);
+                }
+                else {
+                    if (node == nodes[parent].left) {
+                        node = parent;
+                        rotate_right(node);
+                    }
+                    nodes[nodes[node].parent].color = false;
+                    nodes[grandparent].color = true;
+                    rotate_left(grandparent);
+                }
+            }
+            nodes[root].color = false;
+        }
+};
+
+/// @brief Ячейка компактной хэш-таблицы (8 байт); key == compact_none - ячейка свободна
+struct CompactEntry {
+    uint32_t key = compact_none;
+    uint32_t row = 0;
+};
+
+/// @brief Хэш-таблица с открытой адресацией по id страны. Размер - степень двойки,
+/// пробирование по треугольным числам обходит каждую ячейку ровно один раз; при заполнении
+/// больше 3/4 таблица увеличивается вдвое, поэтому строки не теряются и не повторяются
+class CompactHashTable {
+    public:
+        const std::vector<Player>& players;
+        CountryDictionary& dictionary;
+        std::vector<CompactEntry> table;
+        /// @brief Размер таблицы (степень двойки)
+        uint32_t size;
+        /// @brief Число строк в таблице
+        uint32_t element_count = 0;
+
+        CompactHashTable(const std::vector<Player>& players, CountryDictionary& dictionary, uint32_t sz)
+            : players(players), dictionary(dictionary), table(table_size(sz)), size(table_size(sz)) {}
+
+        /// @brief Хэш id страны (мультипликативное хэширование)
+        uint32_t hash_function(uint32_t key) const {
+            return static_cast<uint32_t>((uint64_t(key * 2654435761u) * size) >> 32);
+        }
+
+        /// @brief Пробирование по треугольным числам (при размере-степени двойки - все ячейки)
+        uint32_t prob_sequence(uint32_t hash, uint32_t attempt) const {
+            return static_cast<uint32_t>((hash + uint64_t(attempt) * (attempt + 1) / 2) & (size - 1));
+        }
+
+        /// @brief Вставка строки row из общего массива игроков
+        void insert(uint32_t row) {
+            if (4 * (uint64_t(element_count) + 1) > 3 * uint64_t(size)) grow();
+            place(dictionary.intern(players[row].country), row);
+            element_count++;
+        }
+
+        /// @brief Номера строк игроков из страны key
+        std::vector<uint32_t> search(const std::string& country) const {
+            std::vector<uint32_t> result;
+            uint32_t key = dictionary.find(country);
+            if (key == compact_none) return result;
+            uint32_t hash = hash_function(key);
+            for (uint32_t attempt = 0; attempt < size; attempt++) {
+                const CompactEntry& entry = table[prob_sequence(hash, attempt)];
+                if (entry.key == compact_none) break;
+                if (entry.key == key) result.push_back(entry.row);
+            }
+            return result;
+        }
+
+        size_t memory_bytes() const {
+            return sizeof(*this) + table.capacity() * sizeof(CompactEntry);
+        }
+
+    private:
+        /// @brief Степень двойки, не меньшая requested (и не меньше 1)
+        static uint32_t table_size(uint32_t requested) {
+            uint32_t result = 1;
+            while (result < requested) {
+                if (result > UINT32_MAX / 2) throw std::length_error("CompactHashTable is too large");
+                result <<= 1;
+            }
+            return result;
+        }
+
+        /// @brief Размещение строки: свободная ячейка находится всегда, заполнение не больше 3/4
+        void place(uint32_t key, uint32_t row) {
+            uint32_t hash = hash_function(key);
+            for (uint32_t attempt = 0; attempt < size; attempt++) {
+                CompactEntry& entry = table[prob_sequence(hash, attempt)];
+                if (entry.key == compact_none) {
+                    entry.key = key;
+                    entry.row = row;
+                    return;
+                }
+            }
+            throw std::logic_error("CompactHashTable: no free cell");
+        }
+
+        /// @brief Перенос строк в таблицу вдвое больше
+        void grow() {
+            if (size > UINT32_MAX / 2) throw std::length_error("CompactHashTable is too large");
+            std::vector<CompactEntry> old = std::move(table);
+            size *= 2;
+            table.assign(size, CompactEntry());
+            for (const CompactEntry& entry : old) {
+                if (entry.key != compact_none) place(entry.key, entry.row);
+            }
+        }
+};
+
+/// @brief Память, которую занимает копия игрока (объект и строки в куче)
+size_t player_memory_bytes(const Player& p) {
+    return sizeof(Player) + CountryDictionary::string_heap_bytes(p.country) + CountryDictionary::string_heap_bytes(p.name)
+        + CountryDictionary::string_heap_bytes(p.club) + CountryDictionary::string_heap_bytes(p.position);
+}
+
+/// @brief Память бинарного дерева поиска с копиями Player
+size_t memory_bytes(const BinaryTreeNode* node) {
+    if (!node) return 0;
+    return sizeof(BinaryTreeNode) - sizeof(Player) + player_memory_bytes(node->data) + memory_bytes(node->left) + memory_bytes(node->right);
+}
+
+/// @brief Память красно-черного дерева с копиями Player
+size_t memory_bytes(const RBTreeNode* node) {
+    if (!node) return 0;
+    return sizeof(RBTreeNode) - sizeof(Player) + player_memory_bytes(node->data) + memory_bytes(node->left) + memory_bytes(node->right);
+}
+
+/// @brief Память хэш-таблицы с копиями Player
+size_t memory_bytes(const HashTable& ht) {
+    size_t result = sizeof(ht) + ht.table.capacity() * sizeof(Entry);
+    for (const Entry& entry : ht.table) result += player_memory_bytes(entry.player) - sizeof(Player);
+    return result;
+}
@@ -0,0 +1,310 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/// @file disk_index.h
+/// @brief Индекс по стране, сохраняемый на диск и открываемый через mmap без перестроения
+///
+/// Формат файла не содержит указателей: все ссылки - смещения от начала файла,
+/// поэтому его можно отобразить в память по любому адресу и сразу искать.
+/// [заголовок][строки Player][ключи][номера строк][пул строк]
+
+/// @brief Строка внутри пула строк файла
+struct DiskString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+/// @brief Запись игрока в файле
+struct DiskRow {
+    DiskString country;
+    DiskString name;
+    DiskString club;
+    DiskString position;
+    uint32_t games;
+    int32_t goals;
+};
+
+/// @brief Уникальная страна и ее отрезок [first, first + count) в массиве номеров строк
+struct DiskKey {
+    DiskString key;
+    uint32_t first;
+    uint32_t count;
+};
+
+/// @brief Заголовок файла индекса
+struct DiskIndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t row_count;
+    uint64_t key_count;
+    /// @brief Размер, время изменения и контрольная сумма исходного CSV
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t source_checksum;
+    uint64_t rows_offset;
+    uint64_t keys_offset;
+    uint64_t postings_offset;
+    uint64_t strings_offset;
+    uint64_t file_size;
+    /// @brief Контрольная сумма всего, что идет после заголовка
+    uint64_t payload_checksum;
+};
+
+const char disk_index_magic[8] = {'P', 'L', 'I', 'D', 'X', 0, 0, 0};
+const uint32_t disk_index_version = 1;
+
+/// @brief Хэш FNV-1a (64 бита) для контрольных сумм
+uint64_t fnv1a(const char* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/// @brief Контрольная сумма содержимого файла (0, если файл не открылся)
+uint64_t file_checksum(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return 0;
+    std::vector<char> buffer(1 << 20);
+    uint64_t hash = fnv1a(nullptr, 0);
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        hash = fnv1a(buffer.data(), file.gcount(), hash);
+    }
+    return hash;
+}
+
+/// @brief Запись индекса на диск
+/// @param players Данные, прочитанные из source_file
+/// @param source_file CSV, по которому построен индекс (для проверки актуальности)
+/// @param index_file Имя файла индекса
+/// @return False, если не удалось прочитать исходный файл или записать индекс
+bool write_disk_index(const std::vector<Player>& players, const std::string& source_file, const std::string& index_file) {
+    struct stat source_stat;
+    if (stat(source_file.c_str(), &source_stat) != 0) return false;
+
+    std::string strings;
+    auto add_string = [&](const std::string& s) {
+        DiskString result = {static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(s.size())};
+        strings += s;
+        return result;
+    };
+
+    std::vector<DiskRow> rows;
+    rows.reserve(players.size());
+    for (const Player& p : players)
+        rows.push_back({add_string(p.country), add_string(p.name), add_string(p.club), add_string(p.position), p.games, p.goals});
+
+    // Номера строк, упорядоченные по стране (стабильно - внутри страны по возрастанию номера)
+    std::vector<uint32_t> postings(players.size());
+    for (uint32_t i = 0; i < postings.size(); i++) postings[i] = i;
+    std::stable_sort(postings.begin(), postings.end(), [&](uint32_t a, uint32_t b) {
+        return players[a].country < players[b].country;
+    });
+
+    std::vector<DiskKey> keys;
+    for (uint32_t i = 0; i < postings.size(); i++) {
+        if (keys.empty() || players[postings[i]].country != players[postings[keys.back().first]].country)
+            keys.push_back({rows[postings[i]].country, i, 0});
+        keys.back().count++;
+    }
+
+    DiskIndexHeader header = {};
+    std::memcpy(header.magic, disk_index_magic, sizeof(header.magic));
+    header.version = disk_index_version;
+    header.header_size = sizeof(DiskIndexHeader);
+    header.row_count = rows.size();
+    header.key_count = keys.size();
+    header.source_size = source_stat.st_size;
+    header.source_mtime = source_stat.st_mtime;
+    header.source_checksum = file_checksum(source_file);
+    header.rows_offset = sizeof(DiskIndexHeader);
+    header.keys_offset = header.rows_offset + rows.size() * sizeof(DiskRow);
+    header.postings_offset = header.keys_offset + keys.size() * sizeof(DiskKey);
+    header.strings_offset = header.postings_offset + postings.size() * sizeof(uint32_t);
+    header.file_size = header.strings_offset + strings.size();
+
+    std::vector<char> payload(header.file_size - sizeof(DiskIndexHeader));
+    char* out = payload.data();
+    std::memcpy(out, rows.data(), rows.size() * sizeof(DiskRow));
+    out += rows.size() * sizeof(DiskRow);
+    std::memcpy(out, keys.data(), keys.size() * sizeof(DiskKey));
+    out += keys.size() * sizeof(DiskKey);
+    std::memcpy(out, postings.data(), postings.size() * sizeof(uint32_t));
+    out += postings.size() * sizeof(uint32_t);
+    std::memcpy(out, strings.data(), strings.size());
+    header.payload_checksum = fnv1a(payload.data(), payload.size());
+
+    std::ofstream file(index_file, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(payload.data(), payload.size());
+    return static_cast<bool>(file);
+}
+
+/// @brief Игрок, прочитанный из файла индекса (строки указывают прямо в отображенную память)
+struct PlayerView {
+    std::string_view country;
+    std::string_view name;
+    std::string_view club;
+    std::string_view position;
+    unsigned int games;
+    int goals;
+};
+
+/// @brief Индекс, открытый через mmap только для чтения
+class DiskIndex {
+    public:
+        /// @brief Причина, по которой не удалось открыть индекс
+        std::string error;
+
+        DiskIndex() {}
+        DiskIndex(const DiskIndex&) = delete;
+        DiskIndex& operator=(const DiskIndex&) = delete;
+        ~DiskIndex() { close(); }
+
+        /// @brief Открытие и проверка индекса
+        /// @param index_file Файл индекса
+        /// @param source_file CSV, по которому индекс должен быть построен
+        /// @param full_check True - пересчитать контрольные суммы индекса и исходного файла,
+        /// иначе сверяются только размер и время изменения исходного файла
+        /// @return False, если индекс отсутствует, поврежден или устарел
+        bool open(const std::string& index_file, const std::string& source_file, bool full_check = false) {
+            close();
+            error.clear();
+            int fd = ::open(index_file.c_str(), O_RDONLY);
+            if (fd < 0) return fail("cannot open " + index_file);
+
+            struct stat index_stat;
+            if (fstat(fd, &index_stat) != 0 || (size_t)index_stat.st_size < sizeof(DiskIndexHeader)) {
+                ::close(fd);
+                return fail("index file is truncated");
+            }
+            mapped_size = index_stat.st_size;
+            void* mapped = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (mapped == MAP_FAILED) {
+                mapped_size = 0;
+                return fail("mmap failed");
+            }
+            base = static_cast<const char*>(mapped);
+            header = reinterpret_cast<const DiskIndexHeader*>(base);
+
+            if (std::memcmp(header->magic, disk_index_magic, sizeof(header->magic)) != 0) return fail("bad magic");
+            if (header->version != disk_index_version || header->header_size != sizeof(DiskIndexHeader)) return fail("unsupported version");
+            if (header->file_size != mapped_size) return fail("index file size mismatch");
+
+            struct stat source_stat;
+            if (stat(source_file.c_str(), &source_stat) != 0) return fail("cannot stat " + source_file);
+            if ((uint64_t)source_stat.st_size != header->source_size) return fail("source size changed");
+            if (full_check) {
+                if (fnv1a(base + sizeof(DiskIndexHeader), mapped_size - sizeof(DiskIndexHeader)) != header->payload_checksum) return fail("index checksum mismatch");
+                if (file_checksum(source_file) != header->source_checksum) return fail("source checksum mismatch");
+            }
+            else if (source_stat.st_mtime != header->source_mtime) return fail("source modified");
+
+            // Без полной проверки контрольная сумма не считается, поэтому границы проверяются всегда:
+            // поврежденный или чужой файл с верным file_size не должен приводить к чтению за отображением
+            if (!section_fits(header->rows_offset, header->row_count, sizeof(DiskRow), alignof(DiskRow))
+                || !section_fits(header->keys_offset, header->key_count, sizeof(DiskKey), alignof(DiskKey))
+                || !section_fits(header->postings_offset, header->row_count, sizeof(uint32_t), alignof(uint32_t))
+                || !section_fits(header->strings_offset, 0, 1, 1)) return fail("index section out of bounds");
+            rows = reinterpret_cast<const DiskRow*>(base + header->rows_offset);
+            keys = reinterpret_cast<const DiskKey*>(base + header->keys_offset);
+            postings = reinterpret_cast<const uint32_t*>(base + header->postings_offset);
+            strings = base + header->strings_offset;
+            strings_size = mapped_size - header->strings_offset;
+
+            // Ссылки внутри разделов: линейный проход без хэширования, дешевле контрольной суммы
+            for (uint64_t i = 0; i < header->key_count; i++) {
+                const DiskKey& k = keys[i];
+                if (!string_fits(k.key) || k.first > header->row_count || k.count > header->row_count - k.first) return fail("index key out of bounds");
+            }
+            for (uint64_t i = 0; i < header->row_count; i++) {
+                const DiskRow& r = rows[i];
+                if (postings[i] >= header->row_count) return fail("index posting out of bounds");
+                if (!string_fits(r.country) || !string_fits(r.name) || !string_fits(r.club) || !string_fits(r.position)) return fail("index string out of bounds");
+            }
+            return true;
+        }
+
+        void close() {
+            if (base) munmap(const_cast<char*>(base), mapped_size);
+            base = nullptr;
+            header = nullptr;
+            mapped_size = 0;
+            strings_size = 0;
+        }
+
+        bool is_open() const { return base != nullptr; }
+
+        /// @brief Количество игроков в индексе
+        size_t size() const { return header ? header->row_count : 0; }
+
+        /// @brief Игрок по номеру строки (index < size())
+        PlayerView row(uint32_t index) const {
+            const DiskRow& r = rows[index];
+            return {view(r.country), view(r.name), view(r.club), view(r.position), r.games, r.goals};
+        }
+
+        /// @brief Номера строк игроков из страны key (бинарный поиск по уникальным ключам)
+        /// @return Указатели на начало и конец отрезка в отображенной памяти
+        std::pair<const uint32_t*, const uint32_t*> find(std::string_view key) const {
+            if (!header) return {nullptr, nullptr};
+            const DiskKey* first = keys;
+            const DiskKey* last = keys + header->key_count;
+            const DiskKey* it = std::lower_bound(first, last, key, [&](const DiskKey& k, std::string_view value) {
+                return view(k.key) < value;
+            });
+            if (it == last || view(it->key) != key) return {nullptr, nullptr};
+            return {postings + it->first, postings + it->first + it->count};
+        }
+
+        /// @brief Поиск по ключу с копированием данных (аналог search_hash / RB_search)
+        std::vector<Player> search(const std::string& key) const {
+            std::vector<Player> result;
+            auto range = find(key);
+            for (const uint32_t* it = range.first; it != range.second; ++it) {
+                PlayerView v = row(*it);
+                result.push_back({std::string(v.country), std::string(v.name), std::string(v.club), std::string(v.position), v.games, v.goals});
+            }
+            return result;
+        }
+
+    private:
+        const char* base = nullptr;
+        size_t mapped_size = 0;
+        const DiskIndexHeader* header = nullptr;
+        const DiskRow* rows = nullptr;
+        const DiskKey* keys = nullptr;
+        const uint32_t* postings = nullptr;
+        const char* strings = nullptr;
+        size_t strings_size = 0;
+
+        /// @brief count записей размера size с offset лежат после заголовка внутри отображения и выровнены
+        bool section_fits(uint64_t offset, uint64_t count, size_t size, size_t align) const {
+            return offset >= sizeof(DiskIndexHeader) && offset % align == 0 && offset <= mapped_size
+                && count <= (mapped_size - offset) / size;
+        }
+
+        bool string_fits(DiskString s) const { return s.offset <= strings_size && s.length <= strings_size - s.offset; }
+
+        std::string_view view(DiskString s) const { return std::string_view(strings + s.offset, s.length); }
+
+        bool fail(const std::string& message) {
+            close();
+            error = message;
+            return false;
+        }
+};
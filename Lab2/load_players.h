@@ -0,0 +1,40 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+/// @file load_players.h
+/// @brief Чтение игроков из CSV-файла (общее для start.cpp и benchmark.cpp)
+
+/// @brief Считывает данные игроков из CSV-файла
+/// @return Вектор объектов Player
+std::vector<Player> getPlayers(const std::string& filename) {
+
+    std::vector<Player> players;
+    std::fstream file;
+    file.open(filename, std::ios::in);
+
+    std::string line;
+    getline(file, line);
+
+    while (getline(file, line)) {
+        std::stringstream ss(line);
+        std::string field;
+        Player p;
+
+        getline(ss, p.country, ',');
+        getline(ss, p.name, ',');
+        getline(ss, p.club, ',');
+        getline(ss, p.position, ','); 
+        getline(ss, field, ','); 
+        p.games = stoi(field);
+
+        getline(ss, field);
+        p.goals = stoi(field);
+
+        players.push_back(p);
+    }
+
+    file.close();
+    return players;
+}
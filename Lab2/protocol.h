@@ -0,0 +1,104 @@
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+/// @file protocol.h
+/// @brief Двоичный протокол сервера запросов (server.cpp) и генератора нагрузки (client.cpp)
+///
+/// Каждое сообщение - кадр: u32 длина полезной нагрузки, затем сама нагрузка.
+/// Запрос:  u32 id | u8 op | u8 dataset | u16 len1 | key1 | u16 len2 | key2
+/// Ответ:   u32 id | u8 status | u32 count | count x u32 номер строки (только для op_lookup)
+/// Все числа little-endian. Клиент может отправлять запросы подряд, не дожидаясь ответов;
+/// ответы на одном соединении приходят в порядке запросов.
+
+/// @brief Операции
+enum : uint8_t {
+    /// @brief Номера строк игроков из страны key1
+    op_lookup = 1,
+    /// @brief Количество игроков из страны key1
+    op_count = 2,
+    /// @brief Количество игроков из стран в отрезке [key1, key2]
+    op_count_range = 3,
+};
+
+/// @brief Коды ответа
+enum : uint8_t {
+    status_ok = 0,
+    status_bad_request = 1,
+    status_unknown_dataset = 2,
+};
+
+/// @brief Максимальный размер кадра; соединение с кадром больше закрывается
+const uint32_t max_frame_size = 1 << 20;
+
+struct Request {
+    uint32_t id = 0;
+    uint8_t op = op_lookup;
+    uint8_t dataset = 0;
+    std::string key;
+    std::string key2;
+};
+
+inline void put_u8(std::vector<char>& out, uint8_t value) { out.push_back(static_cast<char>(value)); }
+
+inline void put_u16(std::vector<char>& out, uint16_t value) {
+    char bytes[2];
+    std::memcpy(bytes, &value, 2);
+    out.insert(out.end(), bytes, bytes + 2);
+}
+
+inline void put_u32(std::vector<char>& out, uint32_t value) {
+    char bytes[4];
+    std::memcpy(bytes, &value, 4);
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+inline uint16_t get_u16(const char* data) {
+    uint16_t value;
+    std::memcpy(&value, data, 2);
+    return value;
+}
+
+inline uint32_t get_u32(const char* data) {
+    uint32_t value;
+    std::memcpy(&value, data, 4);
+    return value;
+}
+
+/// @brief Дописывает кадр запроса в out
+inline void encode_request(const Request& request, std::vector<char>& out) {
+    put_u32(out, static_cast<uint32_t>(4 + 1 + 1 + 2 + request.key.size() + 2 + request.key2.size()));
+    put_u32(out, request.id);
+    put_u8(out, request.op);
+    put_u8(out, request.dataset);
+    put_u16(out, static_cast<uint16_t>(request.key.size()));
+    out.insert(out.end(), request.key.begin(), request.key.end());
+    put_u16(out, static_cast<uint16_t>(request.key2.size()));
+    out.insert(out.end(), request.key2.begin(), request.key2.end());
+}
+
+/// @brief Разбор полезной нагрузки запроса
+/// @return False, если нагрузка некорректна
+inline bool decode_request(const char* payload, uint32_t size, Request& request) {
+    if (size < 10) return false;
+    request.id = get_u32(payload);
+    request.op = static_cast<uint8_t>(payload[4]);
+    request.dataset = static_cast<uint8_t>(payload[5]);
+    uint32_t len1 = get_u16(payload + 6);
+    if (8 + len1 + 2 > size) return false;
+    request.key.assign(payload + 8, len1);
+    uint32_t len2 = get_u16(payload + 8 + len1);
+    if (8 + len1 + 2 + len2 != size) return false;
+    request.key2.assign(payload + 10 + len1, len2);
+    return true;
+}
+
+/// @brief Размер первого полного кадра в буфере (вместе с заголовком)
+/// @return 0 - кадр еще не пришел целиком
+inline size_t complete_frame(const char* data, size_t size) {
+    if (size < 4) return 0;
+    uint32_t length = get_u32(data);
+    if (size - 4 < length) return 0;
+    return 4 + length;
+}
@@ -0,0 +1,239 @@
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+
+/// @file query.h
+/// @brief Вторичные индексы по полям игрока и простой планировщик запросов
+
+/// @brief Битовое множество номеров строк
+class RowBitmap {
+    public:
+        /// @brief Слова битовой карты (по 64 строки в слове)
+        std::vector<uint64_t> words;
+
+        RowBitmap(size_t rows = 0) : words((rows + 63) / 64, 0) {}
+
+        void set(uint32_t row) { words[row >> 6] |= 1ull << (row & 63); }
+        bool test(uint32_t row) const { return (words[row >> 6] >> (row & 63)) & 1; }
+
+        /// @brief Пересечение с другой картой того же размера
+        RowBitmap& operator&=(const RowBitmap& other) {
+            for (size_t i = 0; i < words.size(); i++) words[i] &= other.words[i];
+            return *this;
+        }
+
+        /// @brief Перевод карты обратно в отсортированный список строк
+        std::vector<uint32_t> rows() const {
+            std::vector<uint32_t> result;
+            for (size_t i = 0; i < words.size(); i++) {
+                uint64_t word = words[i];
+                while (word) {
+                    result.push_back(static_cast<uint32_t>(i * 64 + __builtin_ctzll(word)));
+                    word &= word - 1; // снимаем младший бит
+                }
+            }
+            return result;
+        }
+};
+
+/// @brief Хэш-индекс по строковому полю: значение -> список номеров строк
+class StringIndex {
+    public:
+        std::unordered_map<std::string, std::vector<uint32_t>> postings;
+
+        void insert(const std::string& key, uint32_t row) { postings[key].push_back(row); }
+
+        /// @brief Номера строк с данным значением (по возрастанию)
+        const std::vector<uint32_t>& find(const std::string& key) const {
+            static const std::vector<uint32_t> empty;
+            auto it = postings.find(key);
+            return it == postings.end() ? empty : it->second;
+        }
+};
+
+/// @brief Упорядоченный индекс по целочисленному полю для запросов по диапазону
+class IntIndex {
+    public:
+        /// @brief Пары (значение, номер строки), отсортированные по значению
+        std::vector<std::pair<long long, uint32_t>> entries;
+
+        void insert(long long value, uint32_t row) { entries.push_back({value, row}); }
+        void build() { std::sort(entries.begin(), entries.end()); }
+
+        /// @brief Границы отрезка [lo, hi] в entries
+        std::pair<size_t, size_t> bounds(long long lo, long long hi) const {
+            auto first = std::lower_bound(entries.begin(), entries.end(), std::make_pair(lo, uint32_t(0)));
+            auto last = std::upper_bound(entries.begin(), entries.end(), std::make_pair(hi, std::numeric_limits<uint32_t>::max()));
+            if (last < first) last = first;
+            return {static_cast<size_t>(first - entries.begin()), static_cast<size_t>(last - entries.begin())};
+        }
+
+        /// @brief Точное количество строк со значением из [lo, hi] за O(log n)
+        size_t count(long long lo, long long hi) const {
+            auto b = bounds(lo, hi);
+            return b.second - b.first;
+        }
+};
+
+/// @brief Поле игрока, по которому строится условие
+enum class Column { country, club, position, games, goals };
+
+/// @brief Условие запроса: равенство для строковых полей, отрезок [lo, hi] для числовых
+struct Predicate {
+    Column column;
+    std::string value;
+    long long lo = std::numeric_limits<long long>::min();
+    long long hi = std::numeric_limits<long long>::max();
+
+    static Predicate equals(Column column, const std::string& value) { return {column, value}; }
+    static Predicate between(Column column, long long lo, long long hi) { return {column, "", lo, hi}; }
+    /// @brief Пустое условие (lo > hi): ни одна строка не подходит
+    static Predicate none(Column column) { return between(column, std::numeric_limits<long long>::max(), std::numeric_limits<long long>::min()); }
+    static Predicate greater(Column column, long long value) {
+        if (value == std::numeric_limits<long long>::max()) return none(column); // value + 1 переполнило бы long long
+        return between(column, value + 1, std::numeric_limits<long long>::max());
+    }
+    static Predicate less(Column column, long long value) {
+        if (value == std::numeric_limits<long long>::min()) return none(column);
+        return between(column, std::numeric_limits<long long>::min(), value - 1);
+    }
+
+    /// @brief Проверка условия на конкретном игроке
+    bool matches(const Player& player) const {
+        switch (column) {
+            case Column::country: return player.country == value;
+            case Column::club: return player.club == value;
+            case Column::position: return player.position == value;
+            case Column::games: return lo <= (long long)player.games && (long long)player.games <= hi;
+            case Column::goals: return lo <= player.goals && player.goals <= hi;
+        }
+        return false;
+    }
+};
+
+/// @brief План выполнения запроса
+struct QueryPlan {
+    /// @brief Порядок условий: от самого селективного к наименее
+    std::vector<size_t> order;
+    /// @brief Оценка числа строк для каждого условия (в исходном порядке)
+    std::vector<size_t> estimates;
+    /// @brief True - пересечение битовых карт, False - фильтрация кандидатов ведущего индекса
+    bool use_bitmaps = false;
+};
+
+/// @brief Набор вторичных индексов по всем полям игрока и планировщик запросов
+class PlayerIndex {
+    public:
+        /// @brief Исходные данные (номер строки - индекс в этом массиве)
+        const std::vector<Player>& players;
+        StringIndex country;
+        StringIndex club;
+        StringIndex position;
+        IntIndex games;
+        IntIndex goals;
+
+        PlayerIndex(const std::vector<Player>& players) : players(players) {
+            for (uint32_t row = 0; row < players.size(); row++) {
+                const Player& p = players[row];
+                country.insert(p.country, row);
+                club.insert(p.club, row);
+                position.insert(p.position, row);
+                games.insert(p.games, row);
+                goals.insert(p.goals, row);
+            }
+            games.build();
+            goals.build();
+        }
+
+        /// @brief Точное число строк, удовлетворяющих одному условию (по индексу, без сканирования)
+        size_t estimate(const Predicate& pred) const {
+            switch (pred.column) {
+                case Column::country: return country.find(pred.value).size();
+                case Column::club: return club.find(pred.value).size();
+                case Column::position: return position.find(pred.value).size();
+                case Column::games: return games.count(pred.lo, pred.hi);
+                case Column::goals: return goals.count(pred.lo, pred.hi);
+            }
+            return players.size();
+        }
+
+        /// @brief Выбор ведущего индекса и стратегии по оценкам стоимости
+        QueryPlan plan(const std::vector<Predicate>& preds) const {
+            QueryPlan result;
+            for (const Predicate& pred : preds) result.estimates.push_back(estimate(pred));
+            for (size_t i = 0; i < preds.size(); i++) result.order.push_back(i);
+            std::sort(result.order.begin(), result.order.end(), [&](size_t a, size_t b) {
+                return result.estimates[a] < result.estimates[b];
+            });
+            if (preds.size() < 2) return result;
+
+            // Фильтрация: проверяем остальные условия на каждом кандидате ведущего индекса,
+            // каждая проверка - произвольный доступ к Player (промах кэша и сравнение строк).
+            // Битовые карты: последовательный проход по спискам строк и по n/64 слов на пересечение.
+            const size_t random_access_cost = 4;
+            size_t driver = result.estimates[result.order[0]];
+            size_t filter_cost = driver * (preds.size() - 1) * random_access_cost;
+            size_t bitmap_cost = 0;
+            for (size_t est : result.estimates) bitmap_cost += est + players.size() / 64;
+            result.use_bitmaps = bitmap_cost < filter_cost;
+            return result;
+        }
+
+        /// @brief Поиск номеров строк, удовлетворяющих всем условиям (по возрастанию)
+        std::vector<uint32_t> query(const std::vector<Predicate>& preds) const {
+            std::vector<uint32_t> result;
+            if (preds.empty()) {
+                for (uint32_t row = 0; row < players.size(); row++) result.push_back(row);
+                return result;
+            }
+
+            QueryPlan p = plan(preds);
+            if (p.estimates[p.order[0]] == 0) return result; // ведущее условие ничего не нашло
+
+            if (p.use_bitmaps) {
+                RowBitmap bitmap = to_bitmap(preds[p.order[0]]);
+                for (size_t i = 1; i < p.order.size(); i++) bitmap &= to_bitmap(preds[p.order[i]]);
+                return bitmap.rows();
+            }
+
+            for_each_row(preds[p.order[0]], [&](uint32_t row) {
+                for (size_t i = 1; i < p.order.size(); i++)
+                    if (!preds[p.order[i]].matches(players[row])) return;
+                result.push_back(row);
+            });
+            std::sort(result.begin(), result.end()); // диапазонный индекс отдает строки по значению, а не по номеру
+            return result;
+        }
+
+        /// @brief То же, что query, но возвращает копии игроков
+        std::vector<Player> query_players(const std::vector<Predicate>& preds) const {
+            std::vector<Player> result;
+            for (uint32_t row : query(preds)) result.push_back(players[row]);
+            return result;
+        }
+
+    private:
+        /// @brief Обход строк, удовлетворяющих одному условию, через соответствующий индекс
+        template <class F>
+        void for_each_row(const Predicate& pred, F&& visit) const {
+            const IntIndex* range_index = nullptr;
+            switch (pred.column) {
+                case Column::country: for (uint32_t row : country.find(pred.value)) visit(row); return;
+                case Column::club: for (uint32_t row : club.find(pred.value)) visit(row); return;
+                case Column::position: for (uint32_t row : position.find(pred.value)) visit(row); return;
+                case Column::games: range_index = &games; break;
+                case Column::goals: range_index = &goals; break;
+            }
+            auto b = range_index->bounds(pred.lo, pred.hi);
+            for (size_t i = b.first; i < b.second; i++) visit(range_index->entries[i].second);
+        }
+
+        RowBitmap to_bitmap(const Predicate& pred) const {
+            RowBitmap bitmap(players.size());
+            for_each_row(pred, [&](uint32_t row) { bitmap.set(row); });
+            return bitmap;
+        }
+};
@@ -0,0 +1,246 @@
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdint>
+
+/// @file result_cache.h
+/// @brief Ограниченный кэш результатов поиска по стране с вытеснением CLOCK
+///
+/// Кэш разбит на сегменты со своими мьютексами, поэтому его можно использовать из
+/// нескольких потоков. Результат хранится как std::shared_ptr на неизменяемый вектор:
+/// вытеснение или сброс записи не портит результат, который уже отдан читателю.
+/// Подключается после search.h.
+
+/// @tparam Result Результат поиска: номера строк (индексы compact_index.h, ConcurrentHashTable)
+/// или копии игроков (RB_search, search_hash)
+template <class Result = std::vector<uint32_t>>
+class ResultCache {
+    public:
+        using Rows = Result;
+        using RowsPtr = std::shared_ptr<const Rows>;
+
+        /// @param capacity Максимальное число ключей в кэше
+        /// @param shard_count Число сегментов (независимых блокировок)
+        ResultCache(size_t capacity, size_t shard_count = 16) {
+            if (shard_count == 0) shard_count = 1;
+            size_t per_shard = std::max<size_t>(1, (capacity + shard_count - 1) / shard_count);
+            for (size_t i = 0; i < shard_count; i++) {
+                shards.push_back(std::make_unique<Shard>());
+                shards.back()->capacity = per_shard;
+            }
+        }
+
+        /// @brief Результат из кэша или вычисленный compute() и сохраненный
+        /// @param compute Поиск в индексе, возвращает Rows
+        template <class Compute>
+        RowsPtr get_or_compute(const std::string& key, Compute&& compute) {
+            Shard& shard = shard_for(key);
+            uint64_t epoch;
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                auto it = shard.index.find(key);
+                if (it != shard.index.end()) {
+                    Slot& slot = shard.slots[it->second];
+                    slot.referenced = true;
+                    hit_count.fetch_add(1, std::memory_order_relaxed);
+                    return slot.rows;
+                }
+                epoch = shard.epoch;
+            }
+            miss_count.fetch_add(1, std::memory_order_relaxed);
+
+            RowsPtr rows = std::make_shared<const Rows>(compute()); // поиск идет без блокировки кэша
+
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            // Если за время поиска в сегменте был сброс, результат мог устареть - не сохраняем
+            if (shard.epoch == epoch) store(shard, key, rows);
+            return rows;
+        }
+
+        /// @brief Сброс записи для ключа (вызывается, когда вставка меняет результат для key)
+        void invalidate(const std::string& key) {
+            Shard& shard = shard_for(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.epoch++;
+            auto it = shard.index.find(key);
+            if (it == shard.index.end()) return;
+            Slot& slot = shard.slots[it->second];
+            slot.key.clear();
+            slot.rows.reset();
+            slot.referenced = false;
+            shard.free_slots.push_back(it->second);
+            shard.index.erase(it);
+            invalidation_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /// @brief Полная очистка кэша
+        void clear() {
+            for (auto& shard : shards) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                shard->epoch++;
+                shard->slots.clear();
+                shard->free_slots.clear();
+                shard->index.clear();
+                shard->hand = 0;
+            }
+        }
+
+        uint64_t hits() const { return hit_count.load(std::memory_order_relaxed); }
+        uint64_t misses() const { return miss_count.load(std::memory_order_relaxed); }
+        uint64_t evictions() const { return eviction_count.load(std::memory_order_relaxed); }
+        uint64_t invalidations() const { return invalidation_count.load(std::memory_order_relaxed); }
+
+        /// @brief Доля попаданий
+        double hit_rate() const {
+            double total = double(hits()) + misses();
+            return total ? hits() / total : 0;
+        }
+
+    private:
+        struct Slot {
+            std::string key;
+            RowsPtr rows;
+            /// @brief Бит обращения CLOCK: ставится при попадании, снимается стрелкой
+            bool referenced = false;
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::vector<Slot> slots;
+            std::vector<size_t> free_slots;
+            std::unordered_map<std::string, size_t> index;
+            size_t capacity = 1;
+            size_t hand = 0;
+            /// @brief Счетчик сбросов: по нему отбрасываются результаты, посчитанные до сброса
+            uint64_t epoch = 0;
+        };
+
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::atomic<uint64_t> hit_count{0};
+        std::atomic<uint64_t> miss_count{0};
+        std::atomic<uint64_t> eviction_count{0};
+        std::atomic<uint64_t> invalidation_count{0};
+
+        Shard& shard_for(const std::string& key) {
+            return *shards[std::hash<std::string>()(key) % shards.size()];
+        }
+
+        /// @brief Сохранение под блокировкой сегмента; при нехватке места вытесняет по CLOCK
+        void store(Shard& shard, const std::string& key, const RowsPtr& rows) {
+            auto it = shard.index.find(key);
+            if (it != shard.index.end()) { // другой поток успел сохранить тот же ключ
+                shard.slots[it->second].rows = rows;
+                return;
+            }
+
+            size_t position;
+            if (!shard.free_slots.empty()) {
+                position = shard.free_slots.back();
+                shard.free_slots.pop_back();
+            }
+            else if (shard.slots.size() < shard.capacity) {
+                position = shard.slots.size();
+                shard.slots.emplace_back();
+            }
+            else {
+                // Стрелка пропускает записи с битом обращения, снимая его, и вытесняет первую без него
+                while (shard.slots[shard.hand].referenced) {
+                    shard.slots[shard.hand].referenced = false;
+                    shard.hand = (shard.hand + 1) % shard.slots.size();
+                }
+                position = shard.hand;
+                shard.hand = (shard.hand + 1) % shard.slots.size();
+                shard.index.erase(shard.slots[position].key);
+                eviction_count.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            Slot& slot = shard.slots[position];
+            slot.key = key;
+            slot.rows = rows;
+            slot.referenced = false;
+            shard.index[key] = position;
+        }
+};
+
+/// @brief Поиск для CachedIndex: search() у индексов номеров строк
+template <class Index>
+auto cached_search(const Index& index, const std::string& key) -> decltype(index.search(key)) { return index.search(key); }
+
+/// @brief Поиск для CachedIndex в красно-черном дереве из search.h
+inline std::vector<Player> cached_search(const RBTree& tree, const std::string& key) { return tree.RB_search(key); }
+
+/// @brief Поиск для CachedIndex в хэш-таблице из search.h
+template <class Hash, class Reduce, class Probe>
+std::vector<Player> cached_search(const BasicHashTable<Hash, Reduce, Probe>& table, const std::string& key) { return table.search_hash(key); }
+
+/// @brief Допускает ли индекс вставку одновременно с поиском (статическое поле concurrent_insert)
+template <class Index, class = void>
+struct is_concurrent_index : std::false_type {};
+template <class Index>
+struct is_concurrent_index<Index, std::void_t<decltype(Index::concurrent_insert)>> : std::bool_constant<Index::concurrent_insert> {};
+
+/// @brief Индекс с кэшем результатов: вставка сбрасывает запись только для страны вставленной строки
+/// @tparam Index Индекс номеров строк с insert(uint32_t row) и полем players (CompactBST, CompactRBTree,
+/// CompactHashTable, ConcurrentHashTable) или индекс игроков из search.h с insert(const Player&) (RBTree, HashTable)
+///
+/// Вставка в индекс, не рассчитанный на одновременные вставку и поиск, идет под исключительной
+/// блокировкой, поиск в нем при промахе кэша - под разделяемой; ConcurrentHashTable не блокируется.
+template <class Index>
+class CachedIndex {
+    public:
+        using Cache = ResultCache<decltype(cached_search(std::declval<const Index&>(), std::string()))>;
+
+        Index& index;
+        Cache cache;
+
+        CachedIndex(Index& index, size_t capacity, size_t shard_count = 16) : index(index), cache(capacity, shard_count) {}
+
+        /// @brief Вставка строки: сначала в индекс, затем сброс ключа, чтобы поиск,
+        /// начатый до вставки, не сохранил в кэш устаревший результат
+        template <class I = Index>
+        auto insert(uint32_t row) -> decltype(std::declval<I&>().insert(row), void()) {
+            {
+                std::unique_lock<std::shared_mutex> lock = lock_for_insert();
+                index.insert(row);
+            }
+            cache.invalidate(index.players[row].country);
+        }
+
+        /// @brief Вставка игрока в индекс из search.h
+        template <class I = Index>
+        auto insert(const Player& player) -> decltype(std::declval<I&>().insert(player), void()) {
+            {
+                std::unique_lock<std::shared_mutex> lock = lock_for_insert();
+                index.insert(player);
+            }
+            cache.invalidate(player.country);
+        }
+
+        /// @brief Результат поиска по стране key (общий неизменяемый вектор)
+        typename Cache::RowsPtr search(const std::string& key) {
+            return cache.get_or_compute(key, [&] {
+                std::shared_lock<std::shared_mutex> lock(index_mutex, std::defer_lock);
+                if (!concurrent) lock.lock();
+                return cached_search(index, key);
+            });
+        }
+
+    private:
+        static constexpr bool concurrent = is_concurrent_index<Index>::value;
+
+        std::shared_mutex index_mutex;
+
+        std::unique_lock<std::shared_mutex> lock_for_insert() {
+            std::unique_lock<std::shared_mutex> lock(index_mutex, std::defer_lock);
+            if (!concurrent) lock.lock();
+            return lock;
+        }
+};
@@ -1,5 +1,13 @@
 
 #include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
 /// @brief Линейный поиск
 /// @param players Массив исходных данных
 /// @param key  Ключ поиска
@@ -80,14 +88,68 @@ struct RBTreeNode {
     RBTreeNode* parent;
     /// @brief Цвет. Значение True - красная вершина, иначе - черная
     bool color = 1; ; // True - красная вершина, False - черная
+    /// @brief Количество вершин в поддереве (включая саму вершину)
+    size_t size = 1;
 
-    RBTreeNode(const Player& player) : data(player), left(nullptr), right(nullptr), parent(nullptr), color(1) {}
+    RBTreeNode(const Player& player) : data(player), left(nullptr), right(nullptr), parent(nullptr), color(1), size(1) {}
+};
+
+/// @brief Итератор по вершинам КЧД в порядке возрастания ключа (без копирования данных)
+class RBTreeIterator {
+    public:
+        RBTreeIterator(const RBTreeNode* node = nullptr) : node(node) {}
+
+        const Player& operator*() const { return node->data; }
+        const Player* operator->() const { return &node->data; }
+
+        /// @brief Переход к следующей вершине (in-order successor через указатели на отца)
+        RBTreeIterator& operator++() {
+            if (node->right) {
+                node = node->right;
+                while (node->left) node = node->left;
+            }
+            else {
+                const RBTreeNode* parent = node->parent;
+                while (parent && node == parent->right) { // поднимаемся, пока мы правый сын
+                    node = parent;
+                    parent = parent->parent;
+                }
+                node = parent;
+            }
+            return *this;
+        }
+
+        bool operator==(const RBTreeIterator& other) const { return node == other.node; }
+        bool operator!=(const RBTreeIterator& other) const { return node != other.node; }
+
+    private:
+        const RBTreeNode* node;
+};
+
+/// @brief Диапазон [begin, end) вершин КЧД для range-based for
+struct RBTreeRange {
+    RBTreeIterator first;
+    RBTreeIterator last;
+
+    RBTreeIterator begin() const { return first; }
+    RBTreeIterator end() const { return last; }
 };
 
 /// @brief Класс красно-черного дерева
 class RBTree {
     public:
         RBTreeNode* root = nullptr;
+
+        /// @brief Размер поддерева (для пустого поддерева 0)
+        static size_t subtree_size(const RBTreeNode* node) {
+            return node ? node->size : 0;
+        }
+
+        /// @brief Количество элементов в дереве
+        size_t size() const {
+            return subtree_size(root);
+        }
+
         /// @brief Вставка вершины
         /// @param player Данные
         void insert(const Player& player){
@@ -97,6 +159,7 @@ class RBTree {
 
             while (node_to_find_place) { //пока не дошли до листа
                 parent_of_new_node = node_to_find_place;
+                node_to_find_place->size++; // новая вершина окажется в этом поддереве
                 if (new_node->data.country < node_to_find_place->data.country) node_to_find_place = node_to_find_place->left; //ключ меньше, поэтому идем влево
                 else node_to_find_place = node_to_find_place->right;
             }
@@ -130,6 +193,9 @@ class RBTree {
         
             node_right_son->left = node;
             node->parent = node_right_son;
+
+            node_right_son->size = node->size; // поддерево целиком перешло к сыну
+            node->size = subtree_size(node->left) + subtree_size(node->right) + 1;
         }
         /// @brief Поворот вправо
         /// @param node Вершина, вокруг которой поворачивают
@@ -147,6 +213,9 @@ class RBTree {
         
             node_left_son->right = node;
             node->parent = node_left_son;
+
+            node_left_son->size = node->size;
+            node->size = subtree_size(node->left) + subtree_size(node->right) + 1;
         }
         
         /// @brief Вставка с проверкой корректности свойств КЧД
@@ -226,6 +295,92 @@ class RBTree {
             return result;
         }
 
+        /// @brief Ранг ключа за O(log n)
+        /// @param key Ключ
+        /// @return Количество элементов, у которых страна строго меньше key
+        size_t rank(const std::string& key) const {
+            size_t result = 0;
+            const RBTreeNode* node = root;
+            while (node) {
+                if (node->data.country < key) {
+                    result += subtree_size(node->left) + 1; // вся левая часть и сама вершина меньше ключа
+                    node = node->right;
+                }
+                else node = node->left;
+            }
+            return result;
+        }
+
+        /// @brief Количество элементов, у которых страна не больше key
+        size_t rank_upper(const std::string& key) const {
+            size_t result = 0;
+            const RBTreeNode* node = root;
+            while (node) {
+                if (key < node->data.country) node = node->left;
+                else {
+                    result += subtree_size(node->left) + 1;
+                    node = node->right;
+                }
+            }
+            return result;
+        }
+
+        /// @brief Количество элементов со страной из отрезка [lo, hi] за O(log n)
+        size_t count_range(const std::string& lo, const std::string& hi) const {
+            if (hi < lo) return 0;
+            return rank_upper(hi) - rank(lo);
+        }
+
+        /// @brief Поиск k-го по порядку элемента (нумерация с 0) за O(log n)
+        /// @return Вершина или nullptr, если k >= size()
+        const RBTreeNode* select(size_t k) const {
+            const RBTreeNode* node = root;
+            while (node) {
+                size_t left_size = subtree_size(node->left);
+                if (k < left_size) node = node->left;
+                else if (k == left_size) return node;
+                else {
+                    k -= left_size + 1;
+                    node = node->right;
+                }
+            }
+            return nullptr;
+        }
+
+        /// @brief Первая вершина со страной >= key
+        const RBTreeNode* lower_bound(const std::string& key) const {
+            const RBTreeNode* result = nullptr;
+            const RBTreeNode* node = root;
+            while (node) {
+                if (node->data.country < key) node = node->right;
+                else {
+                    result = node;
+                    node = node->left;
+                }
+            }
+            return result;
+        }
+
+        /// @brief Первая вершина со страной > key
+        const RBTreeNode* upper_bound(const std::string& key) const {
+            const RBTreeNode* result = nullptr;
+            const RBTreeNode* node = root;
+            while (node) {
+                if (key < node->data.country) {
+                    result = node;
+                    node = node->left;
+                }
+                else node = node->right;
+            }
+            return result;
+        }
+
+        /// @brief Ленивый обход элементов со страной из [lo, hi] по возрастанию, без копирования
+        RBTreeRange range(const std::string& lo, const std::string& hi) const {
+            if (hi < lo) return {RBTreeIterator(), RBTreeIterator()};
+            return {RBTreeIterator(lower_bound(lo)), RBTreeIterator(upper_bound(hi))};
+        }
+
     };
     
 
@@ -233,79 +388,336 @@ class RBTree {
 struct Entry {
     Player player;
     bool occupied = false;
+    /// @brief Полный хэш ключа (позволяет не сравнивать строки при несовпадении хэшей)
+    uint32_t hash = 0;
+    /// @brief Расстояние от домашней ячейки (для Robin Hood)
+    uint32_t distance = 0;
+};
+
+/// @brief Исходная хэш-функция: побайтовое сложение с циклическим сдвигом
+struct LegacyHash {
+    static uint32_t hash(const std::string& key) {
+        unsigned int hash = 0;
+        for (size_t i = 0; i < key.length(); i++) {
+            hash += (unsigned char)(key[i]);
+            hash -= (hash << 13) | (hash >> 19);
+        }
+        return hash;
+    }
+};
+
+/// @brief Хэш-функция, обрабатывающая по 8 байт за шаг
+struct WordHash {
+    static uint32_t hash(const std::string& key) {
+        const uint64_t mul = 0x9E3779B97F4A7C15ull;
+        uint64_t hash = key.size() * mul;
+        size_t i = 0;
+        for (; i + 8 <= key.size(); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, key.data() + i, 8);
+            hash = (hash ^ word) * mul;
+            hash ^= hash >> 29;
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, key.data() + i, key.size() - i);
+        hash = (hash ^ tail) * mul;
+        return static_cast<uint32_t>(hash >> 32);
+    }
+};
+
+/// @brief Хэш на основе CRC32C (аппаратная инструкция SSE4.2, иначе табличная версия)
+struct Crc32Hash {
+    static uint32_t hash(const std::string& key) {
+        uint32_t crc = ~0u;
+        size_t i = 0;
+#ifdef __SSE4_2__
+        uint64_t crc64 = crc;
+        for (; i + 8 <= key.size(); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, key.data() + i, 8);
+            crc64 = _mm_crc32_u64(crc64, word);
+        }
+        crc = static_cast<uint32_t>(crc64);
+        for (; i < key.size(); i++) crc = _mm_crc32_u8(crc, (unsigned char)key[i]);
+#else
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> result;
+            for (uint32_t b = 0; b < 256; b++) {
+                uint32_t value = b;
+                for (int k = 0; k < 8; k++) value = (value >> 1) ^ (0x82F63B78u & (0u - (value & 1)));
+                result[b] = value;
+            }
+            return result;
+        }();
+        for (; i < key.size(); i++) crc = (crc >> 8) ^ table[(crc ^ (unsigned char)key[i]) & 0xFF];
+#endif
+        crc = ~crc;
+        // CRC линеен, поэтому перемешиваем результат, чтобы младшие биты зависели от всех
+        crc ^= crc >> 16;
+        crc *= 0x85ebca6bu;
+        crc ^= crc >> 13;
+        return crc;
+    }
+};
+
+/// @brief Индекс по остатку от деления (исходный вариант)
+struct ModuloReduce {
+    static constexpr bool power_of_two = false;
+    static size_t table_size(size_t requested) { return requested; }
+    static size_t reduce(uint32_t hash, size_t size) { return hash % size; }
+    static size_t wrap(size_t index, size_t size) { return index % size; }
+};
+
+/// @brief Индекс по маске; размер таблицы округляется до степени двойки
+struct MaskReduce {
+    static constexpr bool power_of_two = true;
+    static size_t table_size(size_t requested) {
+        size_t result = 1;
+        while (result < requested) result <<= 1;
+        return result;
+    }
+    static size_t reduce(uint32_t hash, size_t size) { return hash & (size - 1); }
+    static size_t wrap(size_t index, size_t size) { return index & (size - 1); }
+};
+
+/// @brief Быстрое сведение Лемира: (hash * size) >> 32, без деления
+struct LemireReduce {
+    static constexpr bool power_of_two = false;
+    static size_t table_size(size_t requested) { return requested; }
+    static size_t reduce(uint32_t hash, size_t size) { return (uint64_t(hash) * size) >> 32; }
+    static size_t wrap(size_t index, size_t size) { return index % size; }
+};
+
+/// @brief Наименьшее простое число, не меньшее n (0 остается 0 - пустая таблица)
+inline size_t next_prime(size_t n) {
+    if (n == 0) return 0;
+    if (n <= 2) return 2;
+    if (n % 2 == 0) n++;
+    while (true) {
+        bool prime = true;
+        for (size_t d = 3; d * d <= n; d += 2) {
+            if (n % d == 0) {
+                prime = false;
+                break;
+            }
+        }
+        if (prime) return n;
+        n += 2;
+    }
+}
+
+// У пробирования свой размер таблицы и число попыток: пробирование осматривает только
+// различные ячейки, поэтому поиск не возвращает строку дважды, а вставка не ходит по кругу
+
+/// @brief Линейное пробирование
+struct LinearProbe {
+    static constexpr bool robin_hood = false;
+    static constexpr bool prime_size = false;
+    static size_t offset(size_t attempt) { return attempt; }
+    static size_t table_size(size_t size) { return size; }
+    static size_t max_attempts(size_t size) { return size; }
+};
+
+/// @brief Квадратичное пробирование (исходный вариант). attempt * attempt по модулю
+/// произвольного размера повторяет ячейки, поэтому размер - простое число p, а попыток
+/// (p + 1) / 2: при простом p первые (p + 1) / 2 квадратов различны по модулю p
+struct QuadraticProbe {
+    static constexpr bool robin_hood = false;
+    static constexpr bool prime_size = true;
+    static size_t offset(size_t attempt) { return attempt * attempt; }
+    static size_t table_size(size_t size) { return next_prime(size); }
+    static size_t max_attempts(size_t size) { return (size + 1) / 2; }
+};
+
+/// @brief Квадратичное пробирование по треугольным числам: при размере-степени двойки
+/// обходит все ячейки, в отличие от attempt * attempt (размер округляется до степени двойки)
+struct TriangularProbe {
+    static constexpr bool robin_hood = false;
+    static constexpr bool prime_size = false;
+    static size_t offset(size_t attempt) { return attempt * (attempt + 1) / 2; }
+    static size_t table_size(size_t size) { return MaskReduce::table_size(size); }
+    static size_t max_attempts(size_t size) { return size; }
+};
+
+/// @brief Линейное пробирование с вытеснением Robin Hood: при вставке элемент, ушедший
+/// дальше от своей ячейки, занимает место более "богатого"; поиск останавливается раньше
+struct RobinHoodProbe {
+    static constexpr bool robin_hood = true;
+    static constexpr bool prime_size = false;
+    static size_t offset(size_t attempt) { return attempt; }
+    static size_t table_size(size_t size) { return size; }
+    static size_t max_attempts(size_t size) { return size; }
 };
 
-/// @brief Класс, реализующий хэш таблицу
-class HashTable {
+/// @brief Гистограмма длин пробирования: counts[k] - число операций, осмотревших k + 1 ячеек
+struct ProbeHistogram {
+    std::vector<size_t> counts;
+
+    void record(size_t probes) {
+        if (probes == 0) probes = 1;
+        if (counts.size() < probes) counts.resize(probes, 0);
+        counts[probes - 1]++;
+    }
+
+    size_t total() const {
+        size_t result = 0;
+        for (size_t c : counts) result += c;
+        return result;
+    }
+
+    double mean() const {
+        double sum = 0;
+        for (size_t k = 0; k < counts.size(); k++) sum += double(k + 1) * counts[k];
+        size_t n = total();
+        return n ? sum / n : 0;
+    }
+
+    /// @brief Наименьшая длина, не меньше которой доля q операций (0.99 - 99-й перцентиль)
+    size_t percentile(double q) const {
+        size_t n = total(), seen = 0;
+        for (size_t k = 0; k < counts.size(); k++) {
+            seen += counts[k];
+            if (seen >= q * n) return k + 1;
+        }
+        return counts.size();
+    }
+
+    /// @brief Самое длинное пробирование
+    size_t max() const { return counts.size(); }
+};
+
+/// @brief Хэш-таблица с выбираемыми хэш-функцией, сведением хэша к индексу и пробированием
+/// @tparam Hash Хэш-функция (LegacyHash, WordHash, Crc32Hash)
+/// @tparam Reduce Сведение хэша к индексу (ModuloReduce, MaskReduce, LemireReduce)
+/// @tparam Probe Пробирование (LinearProbe, QuadraticProbe, TriangularProbe, RobinHoodProbe)
+template <class Hash, class Reduce, class Probe>
+class BasicHashTable {
+    static_assert(!(Reduce::power_of_two && Probe::prime_size), "quadratic probing needs a prime table size, not MaskReduce");
+
     public:
         /// @brief Массив элементов (сам элемент и занята клетка или нет)
         std::vector<Entry> table;
         /// @brief Размер таблицы   
-        int size;       
+        size_t size;       
         /// @brief Число коллизий      
         int collision_number = 0;
-        
+        /// @brief Гистограмма длин пробирования при вставке
+        ProbeHistogram insert_probes;
+        /// @brief Число элементов
+        size_t element_count = 0;
+
         /// @brief  Хэш функция
         /// @param key Ключ поиска
-        /// @return Значение хэш-функции
-        int hash_function(const std::string& key) const {
-            unsigned int hash = 0;
-            for (int i = 0; i < key.length(); i++) {
-                hash += (unsigned char)(key[i]);
-                hash -= (hash << 13) | (hash >> 19);
-            }
-            return hash % size;
+        /// @return Номер домашней ячейки
+        size_t hash_function(const std::string& key) const {
+            return Reduce::reduce(Hash::hash(key), size);
         }
     
         /// @brief Обработка коллизий (метод открыйто адресации)
-        /// @param hash  Значение хэша
+        /// @param hash  Номер домашней ячейки
         /// @param attempt Номер попытки
         /// @return Индекс, куда будет вставлен элемент
-        int prob_sequence(int hash, int attempt) const {
-            return (hash + attempt * attempt) % size;
+        size_t prob_sequence(size_t hash, size_t attempt) const {
+            return Reduce::wrap(hash + Probe::offset(attempt), size);
         }
     
-    
-        HashTable(int sz) : size(sz), table(sz) {}
+        BasicHashTable(size_t sz) : table(table_size(sz)), size(table_size(sz)) {}
         
-        /// @brief Вставка элемента
+        /// @brief Вставка элемента; если заполнение превысило бы 3/4 или последовательность
+        /// пробирования не нашла свободной ячейки, таблица увеличивается вдвое (строки не теряются)
         /// @param player 
         void insert(const Player& player) {
-            std::string key = player.country;  // Ключом будет страна игрока
-            int key_hash = hash_function(key);
-            int attempt = 0;
-            while (true) {
-                int i = prob_sequence(key_hash, attempt++); //вычисляем позицию в хэш таблице
-                if (!table[i].occupied) { // если позиция еще не занята
-                    table[i].player = player;
-                    table[i].occupied = true;
-                    break;
-                }
-                else if (table[i].player.country != key) collision_number++;
+            if (4 * (element_count + 1) > 3 * size) grow(); // длинные цепочки пробирования при плотном заполнении
+            Entry current;
+            current.player = player;
+            current.occupied = true;
+            current.hash = Hash::hash(player.country);  // Ключом будет страна игрока
+            size_t probes = place(current);
+            while (probes == 0) { // в current - элемент, которому не хватило места (при Robin Hood - вытесненный)
+                grow();
+                probes = place(current);
             }
+            insert_probes.record(probes);
+            element_count++;
         }
        
 
-        /// @brief Поиск по хэш таблице
+        /// @brief Поиск по хэш таблице (только чтение: безопасен из нескольких потоков, пока нет вставок)
         /// @param key 
+        /// @param probes Если задана - в нее добавляется длина пробирования этого поиска
+        /// (своя у каждого потока: таблица ее не хранит)
         /// @return 
-        std::vector<Player> search_hash(const std::string& key) {
+        std::vector<Player> search_hash(const std::string& key, ProbeHistogram* probes = nullptr) const {
             std::vector<Player> result;
-            int hash = hash_function(key);
-            int attempt = 0;
-            while (attempt < size) {
-                int i = prob_sequence(hash, attempt++);
+            if (size == 0) return result;
+            uint32_t full_hash = Hash::hash(key);
+            size_t hash = Reduce::reduce(full_hash, size);
+            size_t attempt = 0;
+            while (attempt < Probe::max_attempts(size)) {
+                size_t i = prob_sequence(hash, attempt);
                 if (!table[i].occupied) break; //Если клетка пуста, то останавливаемся
-                if (table[i].player.country == key) result.push_back(table[i].player); 
+                if (Probe::robin_hood && table[i].distance < attempt) break; // элемент с этим ключом стоял бы раньше
+                attempt++;
+                if (table[i].hash == full_hash && table[i].player.country == key) result.push_back(table[i].player); 
                  // в клетке не всегда находится элемент с нужным ключом 
             }
+            if (probes) probes->record(attempt);
             return result;
         }
-    
- };
-    
-    
-    
 
+    private:
+        /// @brief Размер таблицы с учетом сведения хэша и пробирования
+        static size_t table_size(size_t requested) {
+            return Probe::table_size(Reduce::table_size(requested));
+        }
+
+        /// @brief Размещение current по последовательности пробирования
+        /// @return Число осмотренных ячеек; 0 - свободной ячейки нет, в current остается неразмещенный элемент
+        size_t place(Entry& current) {
+            if (size == 0) return 0;
+            const size_t home = Reduce::reduce(current.hash, size);
+            size_t attempt = 0;
+            while (attempt < Probe::max_attempts(size)) {
+                size_t i = Probe::robin_hood ? Reduce::wrap(home + attempt, size) : prob_sequence(home, attempt); //вычисляем позицию в хэш таблице
+                attempt++;
+                if (!table[i].occupied) { // если позиция еще не занята
+                    table[i] = std::move(current);
+                    return attempt;
+                }
+                if (table[i].hash != current.hash || table[i].player.country != current.player.country) collision_number++;
+                if (Probe::robin_hood && table[i].distance < current.distance) {
+                    std::swap(table[i], current); // дальше переносим вытесненный элемент
+                }
+                if (Probe::robin_hood) current.distance++;
+            }
+            return 0;
+        }
 
+        /// @brief Перенос элементов в таблицу вдвое больше (и еще больше, если и там не хватило пробирования)
+        void grow() {
+            std::vector<Entry> old = std::move(table);
+            size_t requested = std::max<size_t>(2 * size, 1);
+            int collisions = collision_number;
+            while (true) {
+                table.assign(table_size(requested), Entry());
+                size = table.size();
+                bool placed = true;
+                for (const Entry& e : old) {
+                    if (!e.occupied) continue;
+                    Entry copy = e;
+                    copy.distance = 0;
+                    if (place(copy) == 0) {
+                        placed = false;
+                        break;
+                    }
+                }
+                if (placed) break;
+                requested *= 2;
+            }
+            collision_number = collisions; // переразмещение не считается коллизиями вставок
+        }
+    
+ };
 
+/// @brief Исходная хэш-таблица: побайтовый хэш, остаток от деления, квадратичное пробирование (простой размер)
+using HashTable = BasicHashTable<LegacyHash, ModuloReduce, QuadraticProbe>;
@@ -0,0 +1,285 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <cerrno>
+#include <csignal>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include "Player.h"
+#include "load_players.h"
+#include "search.h"
+#include "concurrent_hash.h"
+#include "protocol.h"
+
+/// @file server.cpp
+/// @brief Резидентный сервер запросов: данные и индексы строятся один раз при запуске
+///
+/// Запуск: ./server [--stdin] [--socket путь] [--threads N] [файлы...]
+/// Номер набора данных в запросе - индекс файла в списке. В режиме --stdin кадры
+/// читаются из stdin, ответы пишутся в stdout. Иначе сервер слушает Unix-сокет;
+/// каждый рабочий поток привязан к своему ядру и обслуживает соединения через свой epoll.
+
+/// @brief Набор данных с прогретыми индексами (только чтение, общий для всех потоков)
+struct Dataset {
+    std::vector<Player> players;
+    /// @brief Номера строк по стране (по возрастанию) для op_lookup
+    ConcurrentHashTable hash;
+    RBTree rbt;
+
+    Dataset(const std::string& filename)
+        : players(getPlayers(filename)), hash(players, std::max<size_t>(1, players.size() * 2)) {
+        if (!hash.bulk_build(1)) throw std::runtime_error("hash index is full: " + filename);
+        for (const Player& player : players) rbt.insert(player);
+    }
+};
+
+std::vector<std::unique_ptr<Dataset>> datasets;
+
+/// @brief Выполнение одного запроса, ответ дописывается в out
+void handle_request(const char* payload, uint32_t size, std::vector<char>& out) {
+    Request request;
+    size_t frame_start = out.size();
+    put_u32(out, 0); // длина, заполняется в конце
+
+    if (!decode_request(payload, size, request)) {
+        put_u32(out, size >= 4 ? get_u32(payload) : 0);
+        put_u8(out, status_bad_request);
+        put_u32(out, 0);
+    }
+    else if (request.dataset >= datasets.size()) {
+        put_u32(out, request.id);
+        put_u8(out, status_unknown_dataset);
+        put_u32(out, 0);
+    }
+    else {
+        const Dataset& ds = *datasets[request.dataset];
+        put_u32(out, request.id);
+        switch (request.op) {
+            case op_lookup: {
+                std::vector<uint32_t> rows = ds.hash.search(request.key);
+                put_u8(out, status_ok);
+                put_u32(out, static_cast<uint32_t>(rows.size()));
+                for (uint32_t row : rows) put_u32(out, row);
+                break;
+            }
+            case op_count:
+                put_u8(out, status_ok);
+                put_u32(out, static_cast<uint32_t>(ds.rbt.count_range(request.key, request.key)));
+                break;
+            case op_count_range:
+                put_u8(out, status_ok);
+                put_u32(out, static_cast<uint32_t>(ds.rbt.count_range(request.key, request.key2)));
+                break;
+            default:
+                put_u8(out, status_bad_request);
+                put_u32(out, 0);
+        }
+    }
+
+    uint32_t length = static_cast<uint32_t>(out.size() - frame_start - 4);
+    std::memcpy(out.data() + frame_start, &length, 4);
+}
+
+/// @brief Разбор всех полных кадров из in; обработанные байты удаляются
+/// @return False - кадр недопустимого размера, соединение нужно закрыть
+bool process_frames(std::vector<char>& in, std::vector<char>& out) {
+    size_t pos = 0;
+    while (in.size() - pos >= 4) {
+        if (get_u32(in.data() + pos) > max_frame_size) return false;
+        size_t frame = complete_frame(in.data() + pos, in.size() - pos);
+        if (frame == 0) break;
+        handle_request(in.data() + pos + 4, static_cast<uint32_t>(frame - 4), out);
+        pos += frame;
+    }
+    in.erase(in.begin(), in.begin() + pos);
+    return true;
+}
+
+/// @brief Режим stdin/stdout: один поток, блокирующий ввод-вывод
+int serve_stdin() {
+    std::vector<char> in, out;
+    char buffer[1 << 16];
+    while (true) {
+        ssize_t n = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        in.insert(in.end(), buffer, buffer + n);
+        if (!process_frames(in, out)) return 1;
+        size_t written = 0;
+        while (written < out.size()) {
+            ssize_t w = write(STDOUT_FILENO, out.data() + written, out.size() - written);
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0) return 1;
+            written += w;
+        }
+        out.clear();
+    }
+    return 0;
+}
+
+/// @brief Неотправленных байт ответов, выше которых соединение перестает читать запросы
+/// (клиент, не читающий ответы, не раздувает буфер: запросы ждут в сокете)
+const size_t out_high_water = 1 << 20;
+
+/// @brief Состояние соединения
+struct Connection {
+    std::vector<char> in;
+    std::vector<char> out;
+    size_t out_pos = 0;
+    /// @brief События, на которые соединение подписано в epoll
+    uint32_t events = EPOLLIN;
+
+    /// @brief Чтение приостановлено, пока ответы не ушли ниже out_high_water
+    bool paused() const { return out.size() - out_pos > out_high_water; }
+};
+
+/// @brief Отправка накопленных ответов; при заполнении сокета ждем EPOLLOUT,
+/// при переполнении буфера ответов снимаем EPOLLIN до его освобождения
+/// @return False - соединение закрыто
+bool flush(int epoll_fd, int fd, Connection& conn) {
+    while (conn.out_pos < conn.out.size()) {
+        ssize_t w = send(fd, conn.out.data() + conn.out_pos, conn.out.size() - conn.out_pos, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (w <= 0) return false;
+        conn.out_pos += w;
+    }
+    if (conn.out_pos == conn.out.size()) {
+        conn.out.clear();
+        conn.out_pos = 0;
+    }
+    uint32_t events = (conn.paused() ? 0u : uint32_t(EPOLLIN)) | (conn.out.empty() ? 0u : uint32_t(EPOLLOUT));
+    if (events != conn.events) {
+        epoll_event ev = {};
+        ev.events = events;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+        conn.events = events;
+    }
+    return true;
+}
+
+/// @brief Цикл событий рабочего потока
+void worker_loop(int listen_fd, unsigned int core) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core, &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus); // ошибка не критична
+
+    int epoll_fd = epoll_create1(0);
+    epoll_event ev = {};
+    ev.events = EPOLLIN | EPOLLEXCLUSIVE; // новое соединение будит только один поток
+    ev.data.fd = listen_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+
+    std::unordered_map<int, Connection> connections;
+    std::vector<epoll_event> events(256);
+    char buffer[1 << 16];
+
+    while (true) {
+        int ready = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready < 0) break;
+
+        for (int e = 0; e < ready; e++) {
+            int fd = events[e].data.fd;
+            if (fd == listen_fd) {
+                while (true) {
+                    int client = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (client < 0) break;
+                    epoll_event client_ev = {};
+                    client_ev.events = EPOLLIN;
+                    client_ev.data.fd = client;
+                    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client, &client_ev);
+                    connections[client];
+                }
+                continue;
+            }
+
+            Connection& conn = connections[fd];
+            bool alive = true;
+            if (events[e].events & EPOLLERR) alive = false;
+            else if (events[e].events & (EPOLLIN | EPOLLHUP)) {
+                // Пришедшие запросы (в том числе конвейерные) обрабатываются пачками по прочитанному;
+                // чтение останавливается, когда ответов накопилось больше out_high_water
+                while (alive && !conn.paused()) {
+                    ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                    if (n <= 0) alive = false;
+                    else {
+                        conn.in.insert(conn.in.end(), buffer, buffer + n);
+                        if (!process_frames(conn.in, conn.out)) alive = false;
+                    }
+                }
+            }
+            if (!conn.out.empty() && !flush(epoll_fd, fd, conn)) alive = false;
+            if (!alive) {
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+                close(fd);
+                connections.erase(fd);
+            }
+        }
+    }
+    close(epoll_fd);
+}
+
+int main(int argc, char** argv) {
+    bool use_stdin = false;
+    std::string socket_path = "/tmp/lab2_players.sock";
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> filenames;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--stdin") use_stdin = true;
+        else if (arg == "--socket" && i + 1 < argc) socket_path = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = std::max(1, std::stoi(argv[++i]));
+        else filenames.push_back(arg);
+    }
+    if (filenames.empty()) filenames = {
+        "data_algo/output_players100.csv",
+        "data_algo/output_players1635.csv",
+        "data_algo/output_players15289.csv",
+        "data_algo/output_players46753.csv",
+    };
+
+    for (const std::string& filename : filenames) {
+        datasets.push_back(std::make_unique<Dataset>(filename));
+        std::cerr << "dataset " << datasets.size() - 1 << ": " << filename << ", " << datasets.back()->players.size() << " players\n";
+    }
+
+    if (use_stdin) return serve_stdin();
+
+    signal(SIGPIPE, SIG_IGN);
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "socket path is too long\n";
+        return 1;
+    }
+    std::strcpy(addr.sun_path, socket_path.c_str());
+    unlink(socket_path.c_str());
+    if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listen_fd, 1024) != 0) {
+        std::cerr << "cannot listen on " << socket_path << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    std::cerr << "listening on " << socket_path << " with " << threads << " threads\n";
+
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) workers.emplace_back(worker_loop, listen_fd, t % cores);
+    for (std::thread& worker : workers) worker.join();
+    return 0;
+}
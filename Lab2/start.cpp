@@ -6,44 +6,20 @@
 #include <sstream>
 #include <chrono> 
 #include "Player.h"
+#include "load_players.h"
 #include "search.h"
+#include "query.h"
+#include "disk_index.h"
+#include "compact_index.h"
+#include "bloom_filter.h"
+#include "concurrent_hash.h"
+#include "art.h"
 #include <map>
+#include "../Common/profiler.h"
 
 /// @file start.cpp
 /// @brief Основной файл программы для тестирования сортировки игроков
 
-/// @brief Считывает данные игроков из CSV-файла
-/// @return Вектор объектов Player
-std::vector<Player> getPlayers(const std::string& filename) {
-
-    std::vector<Player> players;
-    std::fstream file;
-    file.open(filename, std::ios::in);
-
-    std::string line;
-    getline(file, line);
-
-    while (getline(file, line)) {
-        std::stringstream ss(line);
-        std::string field;
-        Player p;
-
-        getline(ss, p.country, ',');
-        getline(ss, p.name, ',');
-        getline(ss, p.club, ',');
-        getline(ss, p.position, ','); 
-        getline(ss, field, ','); 
-        p.games = stoi(field);
-
-        getline(ss, field);
-        p.goals = stoi(field);
-
-        players.push_back(p);
-    }
-
-    file.close();
-    return players;
-}
 
 
 
@@ -73,22 +49,79 @@ int main() {
     for (std::string current_file_name : filenames) {
     
         std::string key_country = "Russia";
+        ProfileScope load_scope("load");
         std::vector<Player> st = getPlayers(current_file_name);
+        load_scope.finish();
         
+        ProfileScope bst_scope("build BST");
         BinarySearchTree bst;
         for (const auto& player : st)  bst.insert(player);
+        bst_scope.finish();
         
+        ProfileScope rbt_scope("build RBTree");
         RBTree rbt;
         for (const auto& player : st) rbt.insert(player);
+        rbt_scope.finish();
         
+        ProfileScope ht_scope("build HashTable");
         HashTable ht(st.size()*2);
         for (const auto& player : st) ht.insert(player);
+        ht_scope.finish();
+        
+        //Неблокирующая хэш таблица, заполняется параллельно всеми ядрами
+        ProfileScope pht_scope("build ConcurrentHashTable");
+        ConcurrentHashTable pht(st, st.size()*2);
+        pht.bulk_build();
+        pht_scope.finish();
+        
+        //Компактные индексы: id страны и номер строки в st вместо копии Player
+        ProfileScope compact_scope("build compact indexes");
+        CountryDictionary dict(st);
+        CompactBST cbst(st, dict);
+        CompactRBTree crbt(st, dict);
+        CompactHashTable cht(st, dict, st.size()*2);
+        for (uint32_t row = 0; row < st.size(); row++) {
+            cbst.insert(row);
+            crbt.insert(row);
+            cht.insert(row);
+        }
+        compact_scope.finish();
+        
+        //Префиксное дерево (ART) по стране и по клубу: точный поиск, префикс и диапазон
+        ProfileScope art_scope("build ART");
+        ARTIndex art(st);
+        ARTIndex art_club(st, &Player::club);
+        for (uint32_t row = 0; row < st.size(); row++) {
+            art.insert(row);
+            art_club.insert(row);
+        }
+        art_scope.finish();
+        
+        ProfileScope pidx_scope("build PlayerIndex");
+        PlayerIndex pidx(st);
+        pidx_scope.finish();
         
+        //Фильтр Блума для быстрого ответа на запросы стран, которых нет в данных
+        ProfileScope bloom_scope("build Bloom");
+        BloomFilter bloom(st, 0.01);
+        bloom_scope.finish();
+        
+        ProfileScope map_scope("build multimap");
         std::multimap<std::string, Player> datamap;
         for (const auto& item : st) {
             datamap.insert({item.country, item});  // Вставка пары (ключ, значение)
         }
-
+        map_scope.finish();
+        
+        //Индекс на диске: строится один раз, при следующих запусках открывается через mmap
+        //DiskIndex didx;
+        //std::string index_file = current_file_name + ".idx";
+        //if (!didx.open(index_file, current_file_name)) {
+        //    write_disk_index(st, current_file_name, index_file);
+        //    didx.open(index_file, current_file_name);
+        //}
+
+        ProfileScope search_scope("search");
         auto start_time = std::chrono::high_resolution_clock::now();
         // Линейный поиск
         std::vector<Player> res_lin = linear_search(st, key_country);
@@ -99,15 +132,50 @@ int main() {
         //Красно-черное дерево
         //std::vector<Player> res_rbt = rbt.RB_search(key_country);
         
+        //Красно-черное дерево: количество игроков из стран в диапазоне и ранг страны
+        //size_t res_cnt = rbt.count_range("A", "F");
+        //size_t res_rank = rbt.rank(key_country);
+        
         //Хэш таблицы
         //std::vector<Player> res_ht = ht.search_hash(key_country);
         
         //map
         //auto range = datamap.equal_range(key_country); 
+        
+        //Неблокирующая хэш таблица (номера строк в st)
+        //std::vector<uint32_t> res_pht = pht.search(key_country);
+        
+        //Хэш таблица с отсечением промахов фильтром Блума
+        //std::vector<Player> res_bloom = bloom_guarded(bloom, key_country, [&](const std::string& key) { return ht.search_hash(key); });
+        
+        //Компактные индексы (номера строк в st)
+        //std::vector<uint32_t> res_crbt = crbt.search(key_country);
+        
+        //Префиксное дерево: страна, клубы на "Real", страны от "A" до "F"
+        //std::vector<uint32_t> res_art = art.search(key_country);
+        //std::vector<uint32_t> res_real = art_club.prefix("Real");
+        //std::vector<uint32_t> res_art_range = art.range("A", "F");
+        
+        //Индекс на диске
+        //std::vector<Player> res_disk = didx.search(key_country);
+        
+        //Вторичные индексы: вратари с более чем 50 играми из страны key_country
+        //std::vector<uint32_t> res_idx = pidx.query({Predicate::equals(Column::position, "goalkeeper"),
+        //    Predicate::greater(Column::games, 50), Predicate::equals(Column::country, key_country)});
 
         auto end_time = std::chrono::high_resolution_clock::now();
+        search_scope.finish();
         std::chrono::duration<double, std::milli> duration = end_time - start_time;
         std::cout << duration.count() << " ms\n";
+        
+        //Память на одну строку: индексы с копиями Player и компактные (для отсутствующего файла строк нет)
+        double rows = st.size();
+        if (!st.empty())
+            std::cout << "bytes/row BST: " << memory_bytes(bst.root) / rows << " -> " << cbst.memory_bytes() / rows
+                      << ", RBT: " << memory_bytes(rbt.root) / rows << " -> " << crbt.memory_bytes() / rows
+                      << ", HT: " << memory_bytes(ht) / rows << " -> " << cht.memory_bytes() / rows
+                      << " (+ dictionary " << dict.memory_bytes() << " bytes)\n";
+        std::cout << "bloom filter FPR: expected " << bloom.expected_fpr << ", measured " << bloom_false_positive_rate(bloom, st) << "\n";
        // std::cout << ht.collision_number << "\n";
 
 }
@@ -160,6 +228,7 @@ int main() {
         std::cout << player.name << ", " << player.club << "\n";
     }
         */
+    print_profile_report();
     return 0;
 };
 
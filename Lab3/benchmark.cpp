@@ -0,0 +1,246 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <thread>
+#include <barrier>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <bit>
+#include "lcg_simd.h"
+#include "number_theory.h"
+#include "montgomery.h"
+#include "generators.h"
+#include "lcg_fixed.h"
+
+/// @file benchmark.cpp
+/// @brief Пропускная способность генераторов: нс на число, МБ/с, масштабирование по потокам и размеру блока
+///
+/// Запуск: ./benchmark [--threads 1,2,4] [--batch 1,64,4096] [--reps 5] [--ms 50] [генераторы...].
+/// У каждого потока свой экземпляр генератора; блок batch заполняется вызовом fill().
+/// Перед замерами - прогрев, длина прогона подбирается так, чтобы он шел около --ms миллисекунд.
+/// Результат (CSV) печатается в stdout. Нс на число - время прогона на число всех потоков (обратная
+/// пропускная способность), МБ/с считаются по значащим битам числа (max() генератора: у LCG
+/// по модулям, 13-14 бит, у BBS и BM 24).
+
+/// @brief Объединенный LCG на LCG2: модули во время работы, деление на каждом шаге (общий путь get_data)
+/// @tparam Bits Бит в числе при данных модулях (lcg_range_bits)
+template <int Bits>
+class GenericLCGEngine {
+    public:
+        using result_type = uint32_t;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return (result_type(1) << Bits) - 1; }
+
+        GenericLCGEngine(const std::vector<unsigned int>& params) : params(params) {
+            if (lcg_range_bits(params) != Bits) throw std::invalid_argument("LCG moduli do not match the engine bit width");
+        }
+
+        result_type operator()() {
+            LCG2(s1, params[0], params[1], params[2], s2, params[3], params[4], params[5]);
+            return s1 ^ s2;
+        }
+
+        void fill(std::span<uint32_t> out) {
+            for (uint32_t& value : out) value = (*this)();
+        }
+
+    private:
+        std::vector<unsigned int> params;
+        unsigned int s1 = 1;
+        unsigned int s2 = 1;
+};
+
+/// @brief Исходный BBS (по одному биту с возведения в квадрат), число - c1 ^ c2, как в main
+class LegacyBBSEngine {
+    public:
+        using result_type = uint32_t;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0xFFFFFF; }
+
+        LegacyBBSEngine(unsigned long long p, unsigned long long q, unsigned long long seed) : bbs(p, q, seed) {}
+
+        result_type operator()() {
+            result_type c1 = static_cast<result_type>(bbs.next_number(24));
+            result_type c2 = static_cast<result_type>(bbs.next_number(24));
+            return c1 ^ c2;
+        }
+
+        void fill(std::span<uint32_t> out) {
+            for (uint32_t& value : out) value = (*this)();
+        }
+
+    private:
+        BlumBlumShub bbs;
+};
+
+/// @brief mt19937 через uniform_int_distribution, как в цикле замера времени в random_generator.cpp
+class UniformMT19937Engine {
+    public:
+        using result_type = uint32_t;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0xFFFFFF; }
+
+        UniformMT19937Engine(uint32_t seed) : engine(seed), distribution(0, max()) {}
+
+        result_type operator()() { return distribution(engine); }
+
+        void fill(std::span<uint32_t> out) {
+            for (uint32_t& value : out) value = distribution(engine);
+        }
+
+    private:
+        std::mt19937 engine;
+        std::uniform_int_distribution<uint32_t> distribution;
+};
+
+/// @brief Генератор в замере: фабрика вызывается в каждом потоке
+struct BenchGenerator {
+    std::string name;
+    std::function<AnyGenerator()> make;
+};
+
+/// @brief Одна строка результата
+struct BenchResult {
+    std::string generator;
+    int bits;
+    unsigned int threads;
+    size_t batch;
+    /// @brief Чисел на поток за прогон
+    uint64_t numbers;
+    int reps;
+    double median_ns;
+    double min_ns;
+    double numbers_per_s;
+    double mb_per_s;
+};
+
+std::vector<BenchGenerator> all_generators() {
+    std::vector<BenchGenerator> generators;
+    std::vector<std::pair<std::string, std::vector<unsigned long long>>> registry_params = {
+        {"lcg", {905, 582, 8191, 2701, 27, 8191}},
+        {"bbs", {2051719, 4406159, 182946}},
+        {"bm", {902626523}},
+        {"mt19937", {5489}},
+        {"mt19937_64", {5489}},
+    };
+    for (const auto& [name, params] : registry_params)
+        generators.push_back({name, [name, params] { return make_generator(name, params); }});
+    // Та же последовательность, что у "lcg": деление во время работы против модулей-констант (lcg_fixed.h)
+    generators.push_back({"lcg_generic", [] { return AnyGenerator(GenericLCGEngine<13>({905, 582, 8191, 2701, 27, 8191})); }});
+    generators.push_back({"lcg_fixed", [] { return AnyGenerator(CombinedLCG<905, 582, 8191, 2701, 27, 8191>()); }});
+    generators.push_back({"lcg_generic_6912", [] { return AnyGenerator(GenericLCGEngine<13>({1417, 5, 6912, 2701, 7, 5760})); }});
+    generators.push_back({"lcg_fixed_6912", [] { return AnyGenerator(CombinedLCG<1417, 5, 6912, 2701, 7, 5760>()); }});
+    generators.push_back({"bbs_legacy", [] { return AnyGenerator(LegacyBBSEngine(2051719, 4406159, 182946)); }});
+    generators.push_back({"mt19937_uniform24", [] { return AnyGenerator(UniformMT19937Engine(5489)); }});
+    return generators;
+}
+
+/// @brief Один прогон: threads потоков, каждый per_thread чисел блоками по batch
+/// @return Время в секундах (от общего старта до завершения последнего потока)
+double run_once(const BenchGenerator& generator, unsigned int threads, size_t batch, uint64_t per_thread) {
+    std::barrier start(threads + 1);
+    std::vector<std::thread> pool;
+    for (unsigned int t = 0; t < threads; t++) {
+        pool.emplace_back([&] {
+            AnyGenerator g = generator.make();
+            std::vector<uint32_t> buffer(batch);
+            start.arrive_and_wait();
+            for (uint64_t done = 0; done < per_thread; done += batch) {
+                g.fill(buffer);
+                asm volatile("" : : "g"(buffer.data()) : "memory"); // результат не должен быть выброшен оптимизатором
+            }
+        });
+    }
+    start.arrive_and_wait();
+    auto start_time = std::chrono::steady_clock::now();
+    for (std::thread& thread : pool) thread.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+/// @brief Замер одной конфигурации: подбор длины прогона, прогрев и reps прогонов
+BenchResult run_config(const BenchGenerator& generator, unsigned int threads, size_t batch, int reps, double target_ms) {
+    // Подбор длины: удваиваем, пока прогон не станет дольше 5 мс (это и есть прогрев)
+    uint64_t per_thread = batch;
+    double seconds = run_once(generator, threads, batch, per_thread);
+    while (seconds < 0.005) {
+        per_thread *= 2;
+        seconds = run_once(generator, threads, batch, per_thread);
+    }
+    per_thread = std::max<uint64_t>(1, static_cast<uint64_t>(target_ms / 1000 / seconds * per_thread / batch)) * batch;
+    run_once(generator, threads, batch, per_thread);
+
+    std::vector<double> ns;
+    for (int r = 0; r < reps; r++) ns.push_back(run_once(generator, threads, batch, per_thread) * 1e9 / (per_thread * threads));
+    std::sort(ns.begin(), ns.end());
+    double median = ns[ns.size() / 2];
+
+    int bits = std::bit_width(generator.make().max_value());
+    double numbers_per_s = 1e9 / median;
+    return {generator.name, bits, threads, batch, per_thread, reps, median, ns.front(), numbers_per_s, numbers_per_s * bits / 8 / 1e6};
+}
+
+void print_csv(const std::vector<BenchResult>& results) {
+    std::cout << "generator,bits,threads,batch,numbers_per_thread,reps,median_ns_per_number,min_ns_per_number,numbers_per_s,mb_per_s\n";
+    for (const BenchResult& r : results)
+        std::cout << r.generator << ',' << r.bits << ',' << r.threads << ',' << r.batch << ',' << r.numbers << ',' << r.reps << ','
+                  << r.median_ns << ',' << r.min_ns << ',' << r.numbers_per_s << ',' << r.mb_per_s << "\n";
+}
+
+/// @brief Список чисел через запятую: "1,2,4"
+std::vector<size_t> parse_list(const std::string& text) {
+    std::vector<size_t> values;
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = text.find(',', begin);
+        if (end == std::string::npos) end = text.size();
+        values.push_back(std::stoull(text.substr(begin, end - begin)));
+        begin = end + 1;
+    }
+    return values;
+}
+
+int main(int argc, char** argv) {
+    unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> thread_counts;
+    for (unsigned int t = 1; t < hardware; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(hardware);
+    std::vector<size_t> batches = {1, 64, 4096, 65536};
+    int reps = 5;
+    double target_ms = 50;
+    std::vector<std::string> names;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) thread_counts = parse_list(argv[++i]);
+        else if (arg == "--batch" && i + 1 < argc) batches = parse_list(argv[++i]);
+        else if (arg == "--reps" && i + 1 < argc) reps = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--ms" && i + 1 < argc) target_ms = std::stod(argv[++i]);
+        else names.push_back(arg);
+    }
+
+    std::vector<BenchGenerator> generators = all_generators();
+    if (!names.empty()) {
+        std::vector<BenchGenerator> selected;
+        for (const std::string& name : names) {
+            auto it = std::find_if(generators.begin(), generators.end(), [&](const BenchGenerator& g) { return g.name == name; });
+            if (it == generators.end()) {
+                std::cerr << "Неизвестный генератор: " << name << "\n";
+                return 1;
+            }
+            selected.push_back(*it);
+        }
+        generators = selected;
+    }
+
+    std::vector<BenchResult> results;
+    for (const BenchGenerator& generator : generators)
+        for (size_t threads : thread_counts)
+            for (size_t batch : batches)
+                if (threads > 0 && batch > 0) results.push_back(run_config(generator, static_cast<unsigned int>(threads), batch, reps, target_ms));
+
+    print_csv(results);
+    return 0;
+}
@@ -0,0 +1,280 @@
+#include <vector>
+#include <string>
+#include <span>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <bit>
+#include <stdexcept>
+#include <cstdint>
+
+/// @file generator_service.h
+/// @brief Сервис случайных чисел: потоки-производители и кольцевые буферы готовых блоков
+///
+/// У каждого производителя свой генератор и свое кольцо на один поток записи и много потоков
+/// чтения (SPMC). Ячейка кольца - блок фиксированного размера с номером-последовательностью:
+/// читатель занимает блок сравнением с обменом позиции чтения и копирует его без блокировок.
+/// Полное кольцо останавливает производителя (обратное давление) до освобождения ячейки.
+/// Уровень заполнения и счетчики ожиданий показывают, успевают ли производители (например, BM).
+/// Подключается после generators.h.
+
+/// @brief Кольцо блоков: один поток записи, много потоков чтения
+class BlockRing {
+    public:
+        /// @param capacity Число блоков (округляется вверх до степени двойки)
+        /// @param block_size Чисел в блоке
+        BlockRing(size_t capacity, size_t block_size)
+            : capacity(std::bit_ceil(std::max<size_t>(capacity, 1))), block_size(block_size),
+              slots(new Slot[this->capacity]), data(this->capacity * block_size) {
+            for (size_t i = 0; i < this->capacity; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        /// @brief Свободный блок для записи или nullptr, если кольцо полно (только поток записи)
+        uint32_t* try_reserve() {
+            uint64_t pos = head.load(std::memory_order_relaxed);
+            if (slots[pos & (capacity - 1)].sequence.load(std::memory_order_acquire) != pos) return nullptr;
+            return &data[(pos & (capacity - 1)) * block_size];
+        }
+
+        /// @brief Публикация блока, полученного try_reserve()
+        void publish() {
+            uint64_t pos = head.load(std::memory_order_relaxed);
+            slots[pos & (capacity - 1)].sequence.store(pos + 1, std::memory_order_release);
+            head.store(pos + 1, std::memory_order_release);
+        }
+
+        /// @brief Копирование следующего блока в out (out.size() == block_size); false, если кольцо пусто
+        bool try_pop(std::span<uint32_t> out) {
+            uint64_t pos = tail.load(std::memory_order_relaxed);
+            while (true) {
+                Slot& slot = slots[pos & (capacity - 1)];
+                int64_t diff = int64_t(slot.sequence.load(std::memory_order_acquire) - (pos + 1));
+                if (diff == 0) {
+                    if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) return false;
+                else pos = tail.load(std::memory_order_relaxed);
+            }
+            const uint32_t* block = &data[(pos & (capacity - 1)) * block_size];
+            std::copy(block, block + block_size, out.begin());
+            // Ячейка свободна для записи на следующем круге
+            slots[pos & (capacity - 1)].sequence.store(pos + capacity, std::memory_order_release);
+            freed.fetch_add(1, std::memory_order_release);
+            freed.notify_one();
+            return true;
+        }
+
+        /// @brief Ожидание освобождения ячейки: observed - значение freed_count() до неудачного try_reserve()
+        void wait_for_space(uint64_t observed) const { freed.wait(observed, std::memory_order_acquire); }
+
+        /// @brief Разбудить поток записи, ждущий в wait_for_space() (при остановке)
+        void wake() {
+            freed.fetch_add(1, std::memory_order_release);
+            freed.notify_all();
+        }
+
+        uint64_t freed_count() const { return freed.load(std::memory_order_acquire); }
+
+        /// @brief Готовых блоков в кольце
+        size_t fill() const {
+            uint64_t t = tail.load(std::memory_order_relaxed), h = head.load(std::memory_order_acquire);
+            return h > t ? static_cast<size_t>(h - t) : 0;
+        }
+
+        const size_t capacity;
+        const size_t block_size;
+
+    private:
+        /// @brief Ячейка на своей линии кэша: pos - свободна для записи pos, pos + 1 - готова для чтения pos
+        struct alignas(64) Slot {
+            std::atomic<uint64_t> sequence;
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        std::vector<uint32_t> data;
+        alignas(64) std::atomic<uint64_t> head{0};
+        alignas(64) std::atomic<uint64_t> tail{0};
+        /// @brief Счетчик освобождений: на нем ждет поток записи
+        alignas(64) std::atomic<uint64_t> freed{0};
+};
+
+/// @brief Метрики одного производителя
+struct ProducerStats {
+    uint64_t blocks_produced = 0;
+    uint64_t blocks_consumed = 0;
+    /// @brief Готовых блоков сейчас / емкость кольца
+    size_t fill = 0;
+    size_t capacity = 0;
+    /// @brief Сколько раз кольцо было полно (обратное давление: производитель опережает спрос)
+    uint64_t full_waits = 0;
+    /// @brief Время генерации блоков
+    double generate_ms = 0;
+};
+
+/// @brief Метрики сервиса
+struct ServiceStats {
+    std::vector<ProducerStats> producers;
+    /// @brief Сколько раз потребитель ждал пустые кольца (производители не успевают)
+    uint64_t empty_waits = 0;
+
+    /// @brief Средняя доля заполнения колец
+    double fill_ratio() const {
+        size_t fill = 0, capacity = 0;
+        for (const ProducerStats& p : producers) {
+            fill += p.fill;
+            capacity += p.capacity;
+        }
+        return capacity ? double(fill) / capacity : 0;
+    }
+};
+
+/// @brief Пул производителей с кольцами готовых блоков
+class GeneratorService {
+    public:
+        /// @brief Генератор для производителя с данным номером (у каждого свой экземпляр и seed)
+        using Factory = std::function<AnyGenerator(unsigned int producer)>;
+
+        /// @param producers Число потоков-производителей
+        /// @param block_size Чисел в блоке
+        /// @param ring_blocks Емкость кольца каждого производителя в блоках
+        GeneratorService(Factory factory, unsigned int producers, size_t block_size = 4096, size_t ring_blocks = 16)
+            : block_size(block_size) {
+            if (producers == 0 || block_size == 0) throw std::invalid_argument("producers and block_size must be positive");
+            for (unsigned int i = 0; i < producers; i++) workers.push_back(std::make_unique<Producer>(factory(i), ring_blocks, block_size));
+            for (auto& worker : workers) worker->thread = std::thread([this, p = worker.get()] { produce(*p); });
+        }
+
+        GeneratorService(const GeneratorService&) = delete;
+        GeneratorService& operator=(const GeneratorService&) = delete;
+
+        ~GeneratorService() { stop(); }
+
+        /// @brief Блок без ожидания; false, если все кольца пусты
+        bool try_take(std::span<uint32_t> out) {
+            if (out.size() != block_size) throw std::invalid_argument("output size must equal block_size");
+            size_t start = next_ring.fetch_add(1, std::memory_order_relaxed);
+            for (size_t i = 0; i < workers.size(); i++) {
+                Producer& p = *workers[(start + i) % workers.size()];
+                if (p.ring.try_pop(out)) {
+                    p.consumed.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// @brief Блок с ожиданием; false только после stop(), когда кольца пусты
+        bool take(std::span<uint32_t> out) {
+            while (true) {
+                uint64_t observed = published.load(std::memory_order_acquire);
+                if (try_take(out)) return true;
+                if (stopping.load(std::memory_order_acquire)) return false;
+                empty_waits.fetch_add(1, std::memory_order_relaxed);
+                published.wait(observed, std::memory_order_acquire);
+            }
+        }
+
+        /// @brief Остановка производителей; готовые блоки еще можно забрать
+        void stop() {
+            if (stopping.exchange(true)) return;
+            for (auto& worker : workers) worker->ring.wake();
+            published.fetch_add(1, std::memory_order_release);
+            published.notify_all();
+            for (auto& worker : workers) worker->thread.join();
+        }
+
+        ServiceStats stats() const {
+            ServiceStats result;
+            for (const auto& worker : workers) {
+                ProducerStats s;
+                s.blocks_produced = worker->produced.load(std::memory_order_relaxed);
+                s.blocks_consumed = worker->consumed.load(std::memory_order_relaxed);
+                s.fill = worker->ring.fill();
+                s.capacity = worker->ring.capacity;
+                s.full_waits = worker->full_waits.load(std::memory_order_relaxed);
+                s.generate_ms = worker->generate_ns.load(std::memory_order_relaxed) / 1e6;
+                result.producers.push_back(s);
+            }
+            result.empty_waits = empty_waits.load(std::memory_order_relaxed);
+            return result;
+        }
+
+        const size_t block_size;
+
+    private:
+        struct Producer {
+            AnyGenerator generator;
+            BlockRing ring;
+            std::thread thread;
+            std::atomic<uint64_t> produced{0};
+            std::atomic<uint64_t> consumed{0};
+            std::atomic<uint64_t> full_waits{0};
+            std::atomic<uint64_t> generate_ns{0};
+
+            Producer(AnyGenerator generator, size_t ring_blocks, size_t block_size)
+                : generator(std::move(generator)), ring(ring_blocks, block_size) {}
+        };
+
+        std::vector<std::unique_ptr<Producer>> workers;
+        std::atomic<bool> stopping{false};
+        /// @brief Счетчик опубликованных блоков всех колец: на нем ждут потребители
+        alignas(64) std::atomic<uint64_t> published{0};
+        alignas(64) std::atomic<size_t> next_ring{0};
+        std::atomic<uint64_t> empty_waits{0};
+
+        void produce(Producer& p) {
+            while (!stopping.load(std::memory_order_acquire)) {
+                uint64_t observed = p.ring.freed_count();
+                uint32_t* block = p.ring.try_reserve();
+                if (!block) {
+                    // stop() мог выставить stopping и разбудить кольцо после проверки в условии цикла:
+                    // тогда observed уже учитывает wake(), и ожидание на полном кольце не закончится
+                    if (stopping.load(std::memory_order_acquire)) break;
+                    p.full_waits.fetch_add(1, std::memory_order_relaxed);
+                    p.ring.wait_for_space(observed);
+                    continue;
+                }
+                auto start_time = std::chrono::steady_clock::now();
+                p.generator.fill(std::span<uint32_t>(block, block_size));
+                auto end_time = std::chrono::steady_clock::now();
+                p.generate_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count(), std::memory_order_relaxed);
+
+                p.ring.publish();
+                p.produced.fetch_add(1, std::memory_order_relaxed);
+                published.fetch_add(1, std::memory_order_release);
+                published.notify_all();
+            }
+        }
+};
+
+/// @brief Генератор из реестра для независимого потока stream: seed выводится из stream (splitmix64)
+///
+/// "lcg" - свои seed1, seed2; "bbs" - seed, взаимно простой с p q; "bm" и "mt19937" - свой seed.
+inline AnyGenerator make_stream_generator(const std::string& name, std::vector<unsigned long long> params, unsigned int stream) {
+    uint64_t h = 0x9E3779B97F4A7C15ull * (stream + 1);
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    h ^= h >> 31;
+
+    if (name == "lcg" && params.size() >= 6) {
+        params.resize(6);
+        params.push_back(h % std::max<unsigned long long>(params[2], 1));
+        params.push_back((h >> 32) % std::max<unsigned long long>(params[5], 1));
+    } else if (name == "bbs" && params.size() == 3) {
+        unsigned long long n = params[0] * params[1];
+        if (n > 4) {
+            unsigned long long seed = 2 + h % (n - 3);
+            while (std::gcd(seed, n) != 1) seed = seed + 1 < n ? seed + 1 : 2;
+            params[2] = seed;
+        }
+    } else if (name == "bm" && !params.empty()) {
+        params.resize(1);
+        params.push_back(h);
+    } else if (name == "mt19937" || name == "mt19937_64") {
+        params = {h};
+    }
+    return make_generator(name, params);
+}
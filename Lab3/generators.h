@@ -0,0 +1,465 @@
+#include <vector>
+#include <string>
+#include <span>
+#include <map>
+#include <memory>
+#include <random>
+#include <concepts>
+#include <optional>
+#include <functional>
+#include <stdexcept>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <bit>
+#include <algorithm>
+
+/// @file generators.h
+/// @brief Генераторы лабораторной (объединенный LCG, BBS, Блюм-Микали) и общий интерфейс к ним
+///
+/// Каждый генератор оборачивается в движок со стандартным интерфейсом
+/// UniformRandomBitGenerator (result_type, min(), max(), operator()), поэтому подходит
+/// для распределений <random>, и с невиртуальным блочным заполнением fill(std::span).
+/// Для выбора генератора по имени во время работы есть реестр make_generator().
+/// Подключается после lcg_simd.h, number_theory.h и montgomery.h.
+
+/// @brief  Объединенный LCG
+/// @param seed1 Начальное значение для 1 LCG
+/// @param k1 Коэффициент умножения для 1 LCG
+/// @param b1 Коэффициент смещения для 1 LCG
+/// @param m1 Модуль сравнения для 1 LCG
+/// @param seed2 Начальное значение для 2 LCG
+/// @param k2 Коэффициент умножения для 2 LCG
+/// @param b2 Коэффициент смещения для 2 LCG
+/// @param m2 Модуль сравнения для 2 LCG
+void LCG2(unsigned int& seed1, unsigned int k1, unsigned int b1, unsigned int m1, unsigned int& seed2, unsigned int k2, unsigned int b2, unsigned int m2) {
+    seed1 = (k1 * seed1 + b1) % m1;
+    seed2 = (k2 * seed2 + b2) % m2;
+}
+
+/// @brief Получение данных для объединенного LCG
+/// @param N Необходимое количество генерируемых значений
+/// @param result  Вектор с результатом
+/// @param params Вектор параметров, необходимых для использования объединенного LCG
+void get_data(unsigned int N, std::vector<unsigned int>& result, std::vector<unsigned int>& params) {
+
+    // Инициализация генераторов
+    unsigned int s1 = 1;
+    unsigned int s2 = 1;
+    
+    unsigned int k1 = params[0];
+    unsigned int b1 = params[1];
+    unsigned int m1 = params[2];
+
+    unsigned int k2 = params[3];
+    unsigned int b2 = params[4];
+    unsigned int m2 = params[5];
+
+    for (int i = 1; i <= N; i++){
+        LCG2(s1, k1, b1, m1, s2, k2, b2, m2);
+        result.push_back(s1 ^ s2); //Возвращаю xor двух результатов
+    }
+
+}
+
+/// @brief Класс модифицированного генератора Блюм-Блюм-Шуба
+class BlumBlumShub {
+    public:
+        /// @brief Простое p
+        unsigned long long p; 
+        /// @brief Простое q
+        unsigned long long q;
+        /// @brief pq
+        unsigned long long n;
+        /// @brief Начальное значение
+        unsigned long long seed;
+        /// @brief Текущие состояние генератора
+        unsigned long long current;
+    
+        /// @brief Проверка, что число простое
+        bool is_prime(unsigned long long num) {
+            return is_prime_u64(num); //Миллер-Рабин вместо перебора делителей до sqrt(num)
+        }
+    
+        /// @brief Проверка на значение по модулю 3
+        bool is_3_mod_4(unsigned long long num) {
+            return (num % 4) == 3;
+        }
+    
+
+        BlumBlumShub(unsigned long long p, unsigned long long q, unsigned long long seed) {
+            
+            if (!is_prime(p) || !is_prime(q)) throw std::invalid_argument("p and q must be prime numbers");
+            if (!is_3_mod_4(p) || !is_3_mod_4(q)) throw std::invalid_argument("p and q must be congruent to 3 mod 4");
+            if (std::gcd(p, q) != 1) throw std::invalid_argument("p and q must be co-prime");
+            if (seed <= 1 || seed >= (p * q)) throw std::invalid_argument("seed must be in range (1, p*q)");
+    
+            this->p = p;
+            this->q = q;
+            this->n = p * q;
+            this->seed = seed;
+            this->current = (seed * seed) % n;
+        }
+        
+        /// @brief Генерация одного бита
+        bool next_bit() {
+            unsigned long long t = current % n;
+            current = t * t;
+            return current & 1; //Бит
+        }
+    
+        /// @brief Генерация следующего числа (bits = 13) 
+        unsigned long long next_number(int bits = 13) {
+            unsigned long long result = 0;
+            for (int i=0; i < bits; i++) result = (result << 1) | next_bit();
+            return result;
+        }
+};
+    
+
+/// @brief Функция, преобразующая 24 битное число (меняет половинки числа в битовом представлении местами)
+/// @param input 
+/// @return 
+unsigned int transform_24bit(unsigned int input) {
+    
+        const unsigned int abcdef_mask = 0b111111111111000000000000;
+        // const unsigned int g_mask = 0b0000001000000;     
+        const unsigned int hijklm_mask = 0b000000000000111111111111;
+        unsigned int abcdef = (input & abcdef_mask) >> 12;
+        //unsigned int g = (input & g_mask) >> 6;
+        unsigned int hijklm = input & hijklm_mask;
+        unsigned int result = (hijklm << 12) | abcdef;
+    
+        return result;
+    
+}
+
+/// @brief Модифицированный алгоритм Блюма-Микали
+class BlumMicaliGenerator {
+    public:
+        /// @brief Простое число p
+        unsigned long long p; 
+        /// @brief Первообразный корень по модулю p 
+        unsigned long long g; 
+        /// @brief Начальное значение
+        unsigned long long x0;
+        /// @brief Текущее состояние генератора
+        unsigned long long current;
+        /// @brief Таблицы степеней g для быстрого g^current mod p (нет для p = 2)
+        std::optional<FixedBasePow> g_pow;
+        
+        /// @brief Алгоритм проверки числа на простоту
+        /// @param num 
+        /// @return 
+        bool is_prime(unsigned long long num) {
+            return is_prime_u64(num);
+        }
+        
+        /// @brief Поиск первообразных корней по простому модулю p
+        /// @param p Простое число - модуль
+        /// @return  Первый первообразный корень
+        unsigned long long find_primitive_root(unsigned long long p) {
+            return primitive_root(p); //p - 1 раскладывается ро-методом Полларда
+        }
+        
+        /// @brief Алгоритм быстрого возведения в степень по модулю
+        /// @param base основание степени
+        /// @param exp  значение степени
+        /// @param mod  модуль
+        /// @return 
+        unsigned long long modular_pow(unsigned long long base, unsigned long long exp, unsigned long long mod) {
+            unsigned long long result = 1;
+            base %= mod;
+            while (exp > 0) {
+                if (exp % 2 == 1) result = static_cast<unsigned __int128>(result) * base % mod; //128 бит: без переполнения при большом mod
+                exp >>= 1;
+                base = static_cast<unsigned __int128>(base) * base % mod;
+            }
+            return result;
+        }
+
+        /// @param prime Простой модуль
+        /// @param seed Начальное значение (x0 = seed mod p)
+        BlumMicaliGenerator(unsigned long long prime, unsigned long long seed = 19270) : p(prime) {
+            if (!is_prime(p)) throw std::invalid_argument("Provided number must be a prime");
+
+            g = find_primitive_root(p);
+            if (p > 2) g_pow.emplace(g, p, 64 - __builtin_clzll(p - 1)); //current < p
+            x0 = seed % p; //По умолчанию seed одинаковый (19270)
+            current = x0;
+        }
+
+        /// @brief Генерация следующего бита
+        /// @return 
+        bool next_bit() {
+            current = g_pow ? g_pow->pow(current) : modular_pow(g, current, p);
+            return current > (p - 1) / 2;
+        }
+        /// @brief Генерация следующего 24 битного числа
+        /// @return 
+        unsigned int next_number() {
+            unsigned int result = 0;
+            for (int i=0; i < 24; i++) result = (result << 1) | next_bit();
+            return result;
+        }
+        
+        void generate(std::vector<unsigned int>& output, size_t count) {
+            
+            for (size_t i=0; i < count; i++) output.push_back(transform_24bit(next_number()));
+            
+        }
+};
+
+/// @brief Генератор чисел: UniformRandomBitGenerator с блочным заполнением fill(span)
+template <class G>
+concept NumberGenerator = std::uniform_random_bit_generator<G> && requires(G& g, std::span<uint32_t> out) {
+    g.fill(out);
+};
+
+/// @brief Бит в числе объединенного LCG с модулями m1, m2: s1 < m1 и s2 < m2, поэтому s1 ^ s2 < 2^bits >= max(m1, m2)
+/// @param params {k1, b1, m1, k2, b2, m2}; модули из [1, 2^16], хотя бы один больше 1
+inline int lcg_range_bits(const std::vector<unsigned int>& params) {
+    if (params.size() != 6) throw std::invalid_argument("LCG needs 6 parameters: k1 b1 m1 k2 b2 m2");
+    if (params[2] == 0 || params[5] == 0 || params[2] > 0x10000 || params[5] > 0x10000)
+        throw std::invalid_argument("LCG moduli must be in range [1, 65536]");
+    if (std::max(params[2], params[5]) < 2) throw std::invalid_argument("LCG needs a modulus greater than 1");
+    return std::bit_width(std::bit_ceil(std::max(params[2], params[5])) - 1);
+}
+
+/// @brief Объединенный LCG (s1 ^ s2), блоки считает SimdCombinedLCG
+/// @tparam Bits Бит в числе (lcg_range_bits): статический max() - точная граница, как требуют распределения <random>.
+/// Модули задаются во время работы, поэтому конструктор проверяет, что они дают ровно Bits бит;
+/// make_lcg_engine() выбирает Bits по параметрам.
+template <int Bits>
+class CombinedLCGEngine {
+    static_assert(Bits >= 1 && Bits <= 16, "LCG moduli are at most 2^16");
+
+    public:
+        using result_type = uint32_t;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return (result_type(1) << Bits) - 1; }
+
+        /// @param params {k1, b1, m1, k2, b2, m2}, как в get_data()
+        CombinedLCGEngine(const std::vector<unsigned int>& params, unsigned int seed1 = 1, unsigned int seed2 = 1)
+            : lcg(checked(params), seed1, seed2) {}
+
+        /// @brief Одно число из буфера на LCGLanes::lanes значений: один шаг дорожек на lanes вызовов
+        result_type operator()() {
+            if (buffered == LCGLanes::lanes) {
+                lcg.fill(buffer, LCGLanes::lanes);
+                buffered = 0;
+            }
+            return buffer[buffered++];
+        }
+
+        /// @brief Сначала остаток буфера operator(), затем дорожки: последовательность не зависит от смешения вызовов.
+        /// Дорожки считают только целые шаги по lanes чисел; хвост короче lanes идет через буфер, иначе
+        /// короткий блок загружал бы и сдвигал все регистры дорожек ради нескольких чисел
+        void fill(std::span<uint32_t> out) {
+            size_t i = 0;
+            while (buffered < LCGLanes::lanes && i < out.size()) out[i++] = buffer[buffered++];
+            size_t whole = (out.size() - i) / LCGLanes::lanes * LCGLanes::lanes;
+            if (whole) lcg.fill(out.data() + i, whole);
+            i += whole;
+            if (i == out.size()) return;
+            lcg.fill(buffer, LCGLanes::lanes);
+            buffered = 0;
+            while (i < out.size()) out[i++] = buffer[buffered++];
+        }
+
+    private:
+        SimdCombinedLCG lcg;
+        unsigned int buffer[LCGLanes::lanes];
+        /// @brief Выдано чисел из buffer (lanes - буфер пуст)
+        int buffered = LCGLanes::lanes;
+
+        static const std::vector<unsigned int>& checked(const std::vector<unsigned int>& params) {
+            if (lcg_range_bits(params) != Bits) throw std::invalid_argument("LCG moduli do not match the engine bit width");
+            return params;
+        }
+};
+
+/// @brief Модифицированный BBS: число - xor двух 24-битных чисел MontgomeryBBS (c1 ^ c2)
+class BBSEngine {
+    public:
+        using result_type = uint32_t;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0xFFFFFF; }
+
+        BBSEngine(unsigned long long p, unsigned long long q, unsigned long long seed) : bbs(p, q, seed) {}
+
+        /// @brief Бит с одного возведения в квадрат
+        int bits_per_step() const { return bbs.bits_per_step; }
+
+        result_type operator()() {
+            result_type c1 = static_cast<result_type>(bbs.next_number(24));
+            result_type c2 = static_cast<result_type>(bbs.next_number(24));
+            return c1 ^ c2;
+        }
+
+        void fill(std::span<uint32_t> out) {
+            const size_t block = 512;
+            uint32_t pairs[2 * block];
+            for (size_t i = 0; i < out.size(); i += block) {
+                size_t count = std::min(block, out.size() - i);
+                bbs.fill(pairs, 2 * count, 24);
+                for (size_t j = 0; j < count; j++) out[i + j] = pairs[2 * j] ^ pairs[2 * j + 1];
+            }
+        }
+
+    private:
+        MontgomeryBBS bbs;
+};
+
+/// @brief Модифицированный Блюм-Микали: 24-битное число после transform_24bit
+class BlumMicaliEngine {
+    public:
+        using result_type = uint32_t;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0xFFFFFF; }
+
+        BlumMicaliEngine(unsigned long long prime, unsigned long long seed = 19270) : bm(prime, seed) {}
+
+        result_type operator()() { return transform_24bit(bm.next_number()); }
+
+        void fill(std::span<uint32_t> out) {
+            for (uint32_t& value : out) value = transform_24bit(bm.next_number());
+        }
+
+    private:
+        BlumMicaliGenerator bm;
+};
+
+/// @brief Стандартный движок <random> с блочным заполнением (для сравнения);
+/// 64-битное число движка дает два 32-битных
+template <class Engine>
+class StdEngine {
+    public:
+        static_assert(Engine::min() == 0 && (Engine::max() == 0xFFFFFFFF || Engine::max() == 0xFFFFFFFFFFFFFFFF), "engine must produce 32 or 64 random bits");
+
+        using result_type = uint32_t;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0xFFFFFFFF; }
+
+        StdEngine(typename Engine::result_type seed) : engine(seed) {}
+
+        result_type operator()() {
+            if constexpr (!wide) return static_cast<result_type>(engine());
+            else {
+                if (has_spare) {
+                    has_spare = false;
+                    return spare;
+                }
+                uint64_t value = engine();
+                spare = static_cast<result_type>(value >> 32);
+                has_spare = true;
+                return static_cast<result_type>(value);
+            }
+        }
+
+        void fill(std::span<uint32_t> out) {
+            if constexpr (!wide) {
+                for (uint32_t& value : out) value = static_cast<result_type>(engine());
+            } else {
+                size_t i = 0;
+                if (has_spare && !out.empty()) out[i++] = (*this)();
+                for (; i + 2 <= out.size(); i += 2) {
+                    uint64_t value = engine();
+                    out[i] = static_cast<result_type>(value);
+                    out[i + 1] = static_cast<result_type>(value >> 32);
+                }
+                if (i < out.size()) out[i] = (*this)();
+            }
+        }
+
+    private:
+        static constexpr bool wide = Engine::max() > 0xFFFFFFFF;
+
+        Engine engine;
+        /// @brief Старшая половина последнего 64-битного числа, еще не выданная
+        result_type spare = 0;
+        bool has_spare = false;
+};
+
+/// @brief Генератор с типом, выбранным во время работы
+///
+/// Один виртуальный вызов на блок fill(), а не на число; max() известен только во время работы,
+/// поэтому для распределений <random> нужен сам движок, а не AnyGenerator.
+class AnyGenerator {
+    public:
+        using result_type = uint32_t;
+
+        template <NumberGenerator G>
+        AnyGenerator(G generator) : impl(std::make_unique<Model<G>>(std::move(generator))) {}
+
+        result_type operator()() { return impl->next(); }
+        void fill(std::span<uint32_t> out) { impl->fill(out); }
+        /// @brief Наибольшее значение генератора
+        result_type max_value() const { return impl->max_value(); }
+
+    private:
+        struct Concept {
+            virtual ~Concept() = default;
+            virtual result_type next() = 0;
+            virtual void fill(std::span<uint32_t> out) = 0;
+            virtual result_type max_value() const = 0;
+        };
+
+        template <class G>
+        struct Model : Concept {
+            G generator;
+            Model(G generator) : generator(std::move(generator)) {}
+            result_type next() override { return generator(); }
+            void fill(std::span<uint32_t> out) override { generator.fill(out); }
+            result_type max_value() const override { return G::max(); }
+        };
+
+        std::unique_ptr<Concept> impl;
+};
+
+/// @brief CombinedLCGEngine с шириной числа, выбранной по модулям
+template <int Bits = 1>
+AnyGenerator make_lcg_engine(const std::vector<unsigned int>& params, unsigned int seed1 = 1, unsigned int seed2 = 1) {
+    if constexpr (Bits < 16) {
+        if (lcg_range_bits(params) != Bits) return make_lcg_engine<Bits + 1>(params, seed1, seed2);
+    }
+    return AnyGenerator(CombinedLCGEngine<Bits>(params, seed1, seed2));
+}
+
+/// @brief Фабрика генератора по списку числовых параметров
+using GeneratorFactory = std::function<AnyGenerator(const std::vector<unsigned long long>&)>;
+
+/// @brief Реестр генераторов: имя -> фабрика
+///
+/// "lcg" {k1, b1, m1, k2, b2, m2[, seed1, seed2]}, "bbs" {p, q, seed}, "bm" {p[, seed]}, "mt19937" {seed}, "mt19937_64" {seed}
+inline std::map<std::string, GeneratorFactory>& generator_registry() {
+    static std::map<std::string, GeneratorFactory> registry = {
+        {"lcg", [](const std::vector<unsigned long long>& params) {
+            if (params.size() == 8) return make_lcg_engine(std::vector<unsigned int>(params.begin(), params.begin() + 6), params[6], params[7]);
+            return make_lcg_engine(std::vector<unsigned int>(params.begin(), params.end()));
+        }},
+        {"bbs", [](const std::vector<unsigned long long>& params) {
+            if (params.size() != 3) throw std::invalid_argument("bbs needs 3 parameters: p q seed");
+            return AnyGenerator(BBSEngine(params[0], params[1], params[2]));
+        }},
+        {"bm", [](const std::vector<unsigned long long>& params) {
+            if (params.size() != 1 && params.size() != 2) throw std::invalid_argument("bm needs parameters: p [seed]");
+            return AnyGenerator(params.size() == 2 ? BlumMicaliEngine(params[0], params[1]) : BlumMicaliEngine(params[0]));
+        }},
+        {"mt19937", [](const std::vector<unsigned long long>& params) {
+            return AnyGenerator(StdEngine<std::mt19937>(params.empty() ? 5489u : static_cast<uint32_t>(params[0])));
+        }},
+        {"mt19937_64", [](const std::vector<unsigned long long>& params) {
+            return AnyGenerator(StdEngine<std::mt19937_64>(params.empty() ? 5489u : params[0]));
+        }},
+    };
+    return registry;
+}
+
+/// @brief Генератор по имени из реестра
+inline AnyGenerator make_generator(const std::string& name, const std::vector<unsigned long long>& params) {
+    auto& registry = generator_registry();
+    auto it = registry.find(name);
+    if (it == registry.end()) throw std::invalid_argument("unknown generator: " + name);
+    return it->second(params);
+}
@@ -0,0 +1,132 @@
+#include <vector>
+#include <array>
+#include <span>
+#include <bit>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/// @file lcg_fixed.h
+/// @brief Объединенный LCG с параметрами времени компиляции и таблица готовых специализаций
+///
+/// В LCG2 модули - значения времени работы, и каждый шаг - два аппаратных деления. Когда k, b и m -
+/// параметры шаблона, остаток по постоянному модулю компилятор заменяет умножением и сдвигом,
+/// модуль 2^n - маской, а модуль 2^n - 1 (8191) - сложением старших бит с младшими. Граница k s + b
+/// тоже известна при компиляции, поэтому часто хватает одного условного вычитания.
+/// Таблица lcg_specializations сопоставляет 20 наборов параметров из main их специализациям.
+/// Подключается после generators.h.
+
+/// @brief x mod m для m и наибольшего x, известных при компиляции
+///
+/// Если x < 2m, остаток - одно условное вычитание; для m = 2^n - 1 старшие биты прибавляются
+/// к младшим (2^n = 1 mod m), пока граница x не станет меньше 2m.
+template <unsigned int m, uint64_t max_x = UINT32_MAX>
+constexpr unsigned int mod_const(unsigned int x) {
+    static_assert(m > 0, "modulus must be positive");
+    if constexpr (max_x < m) return x;
+    else if constexpr (max_x < 2 * uint64_t(m)) return x >= m ? x - m : x;
+    else if constexpr (std::has_single_bit(m)) return x & (m - 1);
+    else if constexpr (std::has_single_bit(uint64_t(m) + 1)) {
+        constexpr int n = std::countr_zero(uint64_t(m) + 1);
+        return mod_const<m, m + (max_x >> n)>((x & m) + (x >> n));
+    } else return x % m;
+}
+
+/// @brief Объединенный LCG (s1 ^ s2) с параметрами шаблона; та же последовательность, что у get_data()
+template <unsigned int k1, unsigned int b1, unsigned int m1, unsigned int k2, unsigned int b2, unsigned int m2>
+class CombinedLCG {
+    public:
+        using result_type = uint32_t;
+        static constexpr result_type min() { return 0; }
+        /// @brief s1 < m1 и s2 < m2, поэтому s1 ^ s2 < 2^n >= max(m1, m2)
+        static constexpr result_type max() { return std::bit_ceil(std::max(m1, m2)) - 1; }
+
+        static_assert(uint64_t(k1) * (m1 - 1) + b1 <= UINT32_MAX && uint64_t(k2) * (m2 - 1) + b2 <= UINT32_MAX,
+                      "k s + b must fit in 32 bits");
+
+        unsigned int s1;
+        unsigned int s2;
+
+        /// @brief Начальные значения приводятся по модулю: состояние всегда меньше m
+        explicit CombinedLCG(unsigned int seed1 = 1, unsigned int seed2 = 1) : s1(seed1 % m1), s2(seed2 % m2) {}
+
+        result_type operator()() {
+            s1 = mod_const<m1, uint64_t(k1) * (m1 - 1) + b1>(k1 * s1 + b1);
+            s2 = mod_const<m2, uint64_t(k2) * (m2 - 1) + b2>(k2 * s2 + b2);
+            return s1 ^ s2;
+        }
+
+        void fill(std::span<uint32_t> out) {
+            for (uint32_t& value : out) value = (*this)();
+        }
+};
+
+/// @brief get_data() для набора параметров P, известного при компиляции
+template <std::array<unsigned int, 6> P>
+void get_data_fixed(unsigned int N, std::vector<unsigned int>& result) {
+    CombinedLCG<P[0], P[1], P[2], P[3], P[4], P[5]> lcg;
+    size_t start = result.size();
+    result.resize(start + N);
+    lcg.fill(std::span<uint32_t>(result.data() + start, N));
+}
+
+/// @brief Наборы параметров {k1, b1, m1, k2, b2, m2} из main, для которых есть специализации
+inline constexpr std::array<std::array<unsigned int, 6>, 20> lcg_parameter_sets = {{
+    {1417, 5, 6912, 2701, 7, 5760},
+    {1417, 51, 6912, 2701, 73, 5760},
+    {3205, 105, 6912, 2701, 191, 5760},
+    {673, 57, 6912, 2701, 239, 5760},
+    {2017, 59, 5292, 3204, 31, 6912},
+    {1401, 15, 6912, 3291, 34, 5292},
+    {3205, 83, 6912, 1093, 1, 5292},
+    {673, 419, 6912, 2701, 91, 5292},
+    {1716, 1292, 8575, 1541, 1, 8470},
+    {1716, 59, 8575, 2311, 79, 8470},
+    {3291, 83, 8575, 2311, 157, 8470},
+    {3291, 1063, 8575, 1541, 71, 8470},
+    {1191, 256, 6125, 1191, 78, 4375},
+    {736, 32, 6125, 2241, 932, 4375},
+    {736, 107, 6125, 1191, 191, 4375},
+    {1191, 13, 6125, 2241, 901, 4375},
+    {905, 582, 8191, 2701, 27, 8191},
+    {1417, 51, 8191, 2701, 73, 8191},
+    {9, 5, 8191, 13, 7, 8191},
+    {725, 90, 8191, 6, 1, 8191},
+}};
+
+/// @brief Функция генерации с интерфейсом get_data() без параметров
+using LCGGenerate = void (*)(unsigned int N, std::vector<unsigned int>& result);
+
+/// @brief Элемент таблицы: параметры и функция генерации для них
+struct LCGSpecialization {
+    std::array<unsigned int, 6> params;
+    LCGGenerate generate;
+};
+
+template <size_t... I>
+constexpr std::array<LCGSpecialization, sizeof...(I)> make_lcg_specializations(std::index_sequence<I...>) {
+    return {{{lcg_parameter_sets[I], &get_data_fixed<lcg_parameter_sets[I]>}...}};
+}
+
+/// @brief Таблица специализаций по всем lcg_parameter_sets
+inline constexpr auto lcg_specializations = make_lcg_specializations(std::make_index_sequence<lcg_parameter_sets.size()>());
+
+/// @brief Специализация для params или nullptr, если ее нет
+inline LCGGenerate find_lcg_specialization(const std::vector<unsigned int>& params) {
+    if (params.size() != 6) return nullptr;
+    for (const LCGSpecialization& s : lcg_specializations)
+        if (std::equal(s.params.begin(), s.params.end(), params.begin())) return s.generate;
+    return nullptr;
+}
+
+/// @brief get_data() через таблицу специализаций; для параметров вне таблицы - обычный get_data()
+/// @return true, если использована специализация
+bool get_data_dispatch(unsigned int N, std::vector<unsigned int>& result, std::vector<unsigned int>& params) {
+    if (LCGGenerate generate = find_lcg_specialization(params)) {
+        generate(N, result);
+        return true;
+    }
+    get_data(N, result, params);
+    return false;
+}
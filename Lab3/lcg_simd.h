@@ -0,0 +1,230 @@
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <thread>
+#include <algorithm>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/// @file lcg_simd.h
+/// @brief Объединенный LCG с несколькими независимыми дорожками и блочным заполнением буфера
+///
+/// Дорожка i стартует со значения x_(i+1) последовательной версии и шагает сразу на
+/// lanes значений: x -> (k^lanes * x + c) mod m. Выход дорожек подряд дает ту же
+/// последовательность s1 ^ s2, что и get_data(). Остаток от деления считается без
+/// деления: частное оценивается умножением на 1/m во float и поправляется на +-1.
+/// Векторная версия собирается с -mavx2 (или -march=native), иначе те же дорожки
+/// считаются обычным циклом.
+
+/// @brief Аффинное отображение x -> (a x + c) mod m: n шагов LCG одним преобразованием
+struct LCGJump {
+    uint64_t a = 1, c = 0;
+};
+
+/// @brief Отображение для n шагов LCG x -> (k x + b) mod m за O(log n) умножений
+///
+/// Композиция аффинных отображений снова аффинна: f(g(x)) = a_f a_g x + (a_f c_g + c_f),
+/// поэтому n-я степень шага считается двоичным возведением в степень.
+/// Верно, пока k x + b не переполняет 32 бита (как в LCG2 для m < 2^16).
+inline LCGJump lcg_jump(unsigned int k, unsigned int b, unsigned int m, uint64_t n) {
+    LCGJump result, power;
+    power.a = k % m;
+    power.c = b % m;
+    while (n > 0) {
+        if (n & 1) {
+            result.a = power.a * result.a % m;
+            result.c = (power.a * result.c + power.c) % m;
+        }
+        power.c = (power.a * power.c + power.c) % m;
+        power.a = power.a * power.a % m;
+        n >>= 1;
+    }
+    return result;
+}
+
+/// @brief Значение LCG через n шагов от x
+inline unsigned int lcg_advance(unsigned int x, unsigned int k, unsigned int b, unsigned int m, uint64_t n) {
+    LCGJump jump = lcg_jump(k, b, m, n);
+    return static_cast<unsigned int>((jump.a * (x % m) + jump.c) % m);
+}
+
+/// @brief Один LCG в виде дорожек
+struct LCGLanes {
+    /// @brief Дорожек всего; векторная версия ведет их 4 независимыми регистрами по 8,
+    /// чтобы цепочки зависимостей умножение -> остаток перекрывались
+    static const int lanes = 32;
+
+    unsigned int k, b, m;
+    /// @brief Множитель и сдвиг для прыжка на lanes шагов
+    unsigned int jump_k, jump_b;
+    /// @brief Текущие значения дорожек: state[i] = x_(pos + i + 1)
+    alignas(32) uint32_t state[lanes];
+
+    LCGLanes(unsigned int k, unsigned int b, unsigned int m, unsigned int seed) : k(k), b(b), m(m) {
+        LCGJump jump = lcg_jump(k, b, m, lanes);
+        jump_k = static_cast<unsigned int>(jump.a);
+        jump_b = static_cast<unsigned int>(jump.c);
+
+        unsigned int x = seed;
+        for (int i = 0; i < lanes; i++) {
+            x = (k * x + b) % m;
+            state[i] = x;
+        }
+    }
+
+    /// @brief Остаток v mod m через оценку частного во float; верно при v < 2^31
+    static uint32_t reduce(uint32_t v, uint32_t m, float inv_m) {
+        int32_t q = static_cast<int32_t>(static_cast<float>(static_cast<int32_t>(v)) * inv_m);
+        int32_t r = static_cast<int32_t>(v) - q * static_cast<int32_t>(m);
+        if (r < 0) r += m;
+        if (r >= static_cast<int32_t>(m)) r -= m;
+        return static_cast<uint32_t>(r);
+    }
+
+    /// @brief Пропуск n значений во всех дорожках
+    void advance(uint64_t n) {
+        LCGJump jump = lcg_jump(k, b, m, n);
+        for (int i = 0; i < lanes; i++) state[i] = static_cast<uint32_t>((jump.a * state[i] + jump.c) % m);
+    }
+
+    /// @brief Сдвиг дорожек на r < lanes значений после неполного блока
+    void shift(int r) {
+        uint32_t next[lanes];
+        for (int i = 0; i < lanes; i++)
+            next[i] = i + r < lanes ? state[i + r] : static_cast<uint32_t>((uint64_t(jump_k) * state[i + r - lanes] + jump_b) % m);
+        for (int i = 0; i < lanes; i++) state[i] = next[i];
+    }
+};
+
+/// @brief Объединенный LCG (s1 ^ s2) с заполнением буфера по LCGLanes::lanes значений за шаг
+class SimdCombinedLCG {
+    public:
+        /// @param params {k1, b1, m1, k2, b2, m2}, как в get_data()
+        SimdCombinedLCG(const std::vector<unsigned int>& params, unsigned int seed1 = 1, unsigned int seed2 = 1)
+            : first(params[0], params[1], params[2], seed1), second(params[3], params[4], params[5], seed2),
+              s1(seed1), s2(seed2) {
+            // Дорожки годятся, если k*x + b не переполняет 32 бита (иначе исходный LCG2 считает
+            // по модулю 2^32 и прыжок неверен) и (m-1)^2 + m < 2^31 для оценки частного
+            lanes_ok = fits(first) && fits(second);
+        }
+
+        /// @brief Запись следующих count значений в out
+        void fill(unsigned int* out, size_t count) {
+            if (!lanes_ok) {
+                for (size_t i = 0; i < count; i++) {
+                    s1 = (first.k * s1 + first.b) % first.m;
+                    s2 = (second.k * s2 + second.b) % second.m;
+                    out[i] = s1 ^ s2;
+                }
+                return;
+            }
+
+            const int lanes = LCGLanes::lanes;
+            size_t i = 0;
+#ifdef __AVX2__
+            const int groups = lanes / 8;
+            __m256i x1[groups], x2[groups];
+            for (int g = 0; g < groups; g++) {
+                x1[g] = _mm256_load_si256(reinterpret_cast<const __m256i*>(first.state + 8 * g));
+                x2[g] = _mm256_load_si256(reinterpret_cast<const __m256i*>(second.state + 8 * g));
+            }
+            const __m256i k1 = _mm256_set1_epi32(first.jump_k), b1 = _mm256_set1_epi32(first.jump_b), m1 = _mm256_set1_epi32(first.m);
+            const __m256i k2 = _mm256_set1_epi32(second.jump_k), b2 = _mm256_set1_epi32(second.jump_b), m2 = _mm256_set1_epi32(second.m);
+            const __m256 inv1 = _mm256_set1_ps(1.0f / first.m), inv2 = _mm256_set1_ps(1.0f / second.m);
+            for (; i + lanes <= count; i += lanes) {
+                for (int g = 0; g < groups; g++) {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 8 * g), _mm256_xor_si256(x1[g], x2[g]));
+                    x1[g] = step(x1[g], k1, b1, m1, inv1);
+                    x2[g] = step(x2[g], k2, b2, m2, inv2);
+                }
+            }
+            for (int g = 0; g < groups; g++) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(first.state + 8 * g), x1[g]);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(second.state + 8 * g), x2[g]);
+            }
+#else
+            const float inv1 = 1.0f / first.m, inv2 = 1.0f / second.m;
+            for (; i + lanes <= count; i += lanes) {
+                for (int l = 0; l < lanes; l++) {
+                    out[i + l] = first.state[l] ^ second.state[l];
+                    first.state[l] = LCGLanes::reduce(first.jump_k * first.state[l] + first.jump_b, first.m, inv1);
+                    second.state[l] = LCGLanes::reduce(second.jump_k * second.state[l] + second.jump_b, second.m, inv2);
+                }
+            }
+#endif
+            int rest = static_cast<int>(count - i);
+            if (rest > 0) {
+                for (int l = 0; l < rest; l++) out[i + l] = first.state[l] ^ second.state[l];
+                first.shift(rest);
+                second.shift(rest);
+            }
+        }
+
+        /// @brief Пропуск n значений за O(log n); для параметров с переполнением 32 бит -
+        /// последовательный пропуск за O(n)
+        void advance(uint64_t n) {
+            if (lanes_ok) {
+                first.advance(n);
+                second.advance(n);
+                return;
+            }
+            for (uint64_t i = 0; i < n; i++) {
+                s1 = (first.k * s1 + first.b) % first.m;
+                s2 = (second.k * s2 + second.b) % second.m;
+            }
+        }
+
+    private:
+        LCGLanes first, second;
+        /// @brief Состояние для последовательного режима
+        unsigned int s1, s2;
+        bool lanes_ok;
+
+        static bool fits(const LCGLanes& g) {
+            uint64_t m = g.m;
+            return m > 0 && uint64_t(g.k) * (m - 1) + g.b <= UINT32_MAX && (m - 1) * (m - 1) + m < (uint64_t(1) << 31);
+        }
+
+#ifdef __AVX2__
+        /// @brief (k x + b) mod m для 8 дорожек
+        static __m256i step(__m256i x, __m256i k, __m256i b, __m256i m, __m256 inv_m) {
+            __m256i v = _mm256_add_epi32(_mm256_mullo_epi32(x, k), b);
+            __m256i q = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(v), inv_m));
+            __m256i r = _mm256_sub_epi32(v, _mm256_mullo_epi32(q, m));
+            r = _mm256_add_epi32(r, _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_setzero_si256(), r), m));   // r < 0
+            r = _mm256_sub_epi32(r, _mm256_andnot_si256(_mm256_cmpgt_epi32(m, r), m));                    // r >= m
+            return r;
+        }
+#endif
+};
+
+/// @brief То же, что get_data(), но через SimdCombinedLCG: N значений дописываются в result
+void get_data_simd(unsigned int N, std::vector<unsigned int>& result, std::vector<unsigned int>& params) {
+    size_t offset = result.size();
+    result.resize(offset + N);
+    SimdCombinedLCG lcg(params);
+    lcg.fill(result.data() + offset, N);
+}
+
+/// @brief То же, что get_data(), но куски последовательности считают threads потоков
+///
+/// Поток t получает отрезок [N t / threads, N (t+1) / threads), переходит к его началу
+/// через advance() и пишет значения прямо на их место в result, поэтому результат
+/// не зависит от числа потоков.
+void get_data_parallel(unsigned int N, std::vector<unsigned int>& result, std::vector<unsigned int>& params,
+                       unsigned int threads = std::max(1u, std::thread::hardware_concurrency())) {
+    size_t offset = result.size();
+    result.resize(offset + N);
+    threads = std::max(1u, std::min(threads, N));
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+        size_t begin = uint64_t(N) * t / threads, end = uint64_t(N) * (t + 1) / threads;
+        workers.emplace_back([&, begin, end] {
+            SimdCombinedLCG lcg(params);
+            lcg.advance(begin);
+            lcg.fill(result.data() + offset + begin, end - begin);
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+}
@@ -0,0 +1,113 @@
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+
+/// @file montgomery.h
+/// @brief Генератор Блюм-Блюм-Шуба и возведение в степень на арифметике Монтгомери
+///
+/// Состояние хранится в форме Монтгомери (Montgomery64), поэтому шаг генератора -
+/// умножения и сдвиги без деления. Подключается после number_theory.h.
+
+/// @brief Генератор Блюм-Блюм-Шуба: x -> x^2 mod n, с каждого возведения в квадрат
+/// берутся floor(log2(log2 n)) младших бит (безопасное для BBS число бит)
+class MontgomeryBBS {
+    public:
+        unsigned long long p;
+        unsigned long long q;
+        unsigned long long n;
+        /// @brief Бит с одного возведения в квадрат
+        int bits_per_step;
+
+        MontgomeryBBS(unsigned long long p, unsigned long long q, unsigned long long seed)
+            : p(p), q(q), n(p * q), bits_per_step(1), mont(checked_modulus(p, q, seed)) {
+            bits_per_step = std::max(1, static_cast<int>(std::floor(std::log2(std::log2(static_cast<double>(n))))));
+            bits_mask = (uint64_t(1) << bits_per_step) - 1;
+            current = mont.square(mont.to_montgomery(seed)); // x0 = seed^2 mod n
+        }
+
+        /// @brief Одно возведение в квадрат, младшие bits_per_step бит нового x
+        uint64_t next_bits() {
+            current = mont.square(current);
+            return mont.from_montgomery(current) & bits_mask;
+        }
+
+        /// @brief Следующее число из bits бит (bits <= 57); остаток бит переходит в следующий вызов
+        unsigned long long next_number(int bits = 24) {
+            while (pool_bits < bits) {
+                pool = (pool << bits_per_step) | next_bits();
+                pool_bits += bits_per_step;
+            }
+            pool_bits -= bits;
+            unsigned long long result = pool >> pool_bits;
+            pool &= (uint64_t(1) << pool_bits) - 1;
+            return result;
+        }
+
+        /// @brief Запись count чисел по bits бит в out
+        void fill(unsigned int* out, size_t count, int bits = 24) {
+            for (size_t i = 0; i < count; i++) out[i] = static_cast<unsigned int>(next_number(bits));
+        }
+
+    private:
+        Montgomery64 mont;
+        /// @brief Текущее x в форме Монтгомери
+        uint64_t current = 0;
+        uint64_t bits_mask = 1;
+        /// @brief Полученные, но еще не выданные биты
+        uint64_t pool = 0;
+        int pool_bits = 0;
+
+        static uint64_t checked_modulus(unsigned long long p, unsigned long long q, unsigned long long seed) {
+            if (!is_prime_u64(p) || !is_prime_u64(q)) throw std::invalid_argument("p and q must be prime numbers");
+            if (p % 4 != 3 || q % 4 != 3) throw std::invalid_argument("p and q must be congruent to 3 mod 4");
+            if (p == q) throw std::invalid_argument("p and q must be co-prime");
+            if (q > UINT64_MAX / p) throw std::invalid_argument("p*q must fit in 64 bits");
+            if (seed <= 1 || seed >= p * q) throw std::invalid_argument("seed must be in range (1, p*q)");
+            if (std::gcd(seed, p * q) != 1) throw std::invalid_argument("seed must be co-prime with p*q");
+            return p * q;
+        }
+};
+
+/// @brief Возведение фиксированного основания в степень по таблицам окон
+///
+/// Для каждого 8-битного разряда показателя заранее посчитаны base^(d 2^(8 i)), d = 0..255,
+/// в форме Монтгомери. Степень - произведение по одному элементу из каждой таблицы:
+/// для 30-битного показателя 4 умножения без возведений в квадрат и без деления.
+class FixedBasePow {
+    public:
+        static const int window = 8;
+
+        /// @param base Основание
+        /// @param mod Нечетный модуль
+        /// @param exponent_bits Наибольшая длина показателя в битах
+        FixedBasePow(uint64_t base, uint64_t mod, int exponent_bits = 64)
+            : mont(mod), digits((std::max(1, exponent_bits) + window - 1) / window), table(size_t(digits) << window) {
+            uint64_t power = mont.to_montgomery(base); // base^(2^(8 i))
+            for (int i = 0; i < digits; i++) {
+                uint64_t* row = &table[size_t(i) << window];
+                row[0] = mont.to_montgomery(1);
+                for (int d = 1; d < (1 << window); d++) row[d] = mont.multiply(row[d - 1], power);
+                power = mont.multiply(row[(1 << window) - 1], power);
+            }
+        }
+
+        /// @brief base^exp mod mod; exp < 2^exponent_bits
+        uint64_t pow(uint64_t exp) const {
+            uint64_t result = table[exp & ((1 << window) - 1)];
+            for (int i = 1; i < digits; i++) {
+                exp >>= window;
+                result = mont.multiply(result, table[(size_t(i) << window) | (exp & ((1 << window) - 1))]);
+            }
+            return mont.from_montgomery(result);
+        }
+
+    private:
+        Montgomery64 mont;
+        int digits;
+        /// @brief digits строк по 256 степеней
+        std::vector<uint64_t> table;
+};
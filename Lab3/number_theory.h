@@ -0,0 +1,189 @@
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+
+/// @file number_theory.h
+/// @brief Арифметика по 64-битному модулю: Монтгомери, проверка простоты, разложение, первообразный корень
+///
+/// Проверка простоты - детерминированный Миллер-Рабин (7 оснований верны для всех n < 2^64),
+/// разложение - ро-метод Полларда в варианте Брента. Оба работают в форме Монтгомери, поэтому
+/// подготовка генератора с 64-битным модулем занимает микросекунды, а не перебор до sqrt(n).
+
+/// @brief Арифметика Монтгомери по нечетному модулю n
+///
+/// Число x хранится как x R mod n (R = 2^64). Произведение таких чисел приводится
+/// сдвигом и умножениями (REDC) без деления.
+class Montgomery64 {
+    public:
+        uint64_t n;
+        /// @brief n^(-1) mod 2^64
+        uint64_t n_inv;
+        /// @brief R^2 mod n, для перевода в форму Монтгомери
+        uint64_t r2;
+
+        explicit Montgomery64(uint64_t n) : n(n) {
+            if (n % 2 == 0) throw std::invalid_argument("Montgomery modulus must be odd");
+            // Обратный по модулю 2^64 методом Ньютона: каждая итерация удваивает число верных бит
+            n_inv = n;
+            for (int i = 0; i < 5; i++) n_inv *= 2 - n * n_inv;
+            uint64_t r = (0 - n) % n; // 2^64 mod n
+            r2 = static_cast<uint64_t>(static_cast<unsigned __int128>(r) * r % n);
+        }
+
+        /// @brief t R^(-1) mod n для t < n 2^64
+        ///
+        /// m = t n^(-1) mod 2^64, младшие слова t и m n совпадают, поэтому (t - m n) / 2^64 -
+        /// разность старших слов из (-n, n): без переполнения при любом нечетном n < 2^64.
+        uint64_t reduce(unsigned __int128 t) const {
+            uint64_t m = static_cast<uint64_t>(t) * n_inv;
+            uint64_t t_high = static_cast<uint64_t>(t >> 64);
+            uint64_t mn_high = static_cast<uint64_t>((static_cast<unsigned __int128>(m) * n) >> 64);
+            return t_high >= mn_high ? t_high - mn_high : t_high - mn_high + n;
+        }
+
+        uint64_t to_montgomery(uint64_t x) const { return reduce(static_cast<unsigned __int128>(x % n) * r2); }
+        uint64_t from_montgomery(uint64_t x) const { return reduce(x); }
+        uint64_t multiply(uint64_t a, uint64_t b) const { return reduce(static_cast<unsigned __int128>(a) * b); }
+        uint64_t square(uint64_t a) const { return multiply(a, a); }
+
+        /// @brief a + b mod n (оба в форме Монтгомери)
+        uint64_t add(uint64_t a, uint64_t b) const {
+            uint64_t sum = a + b;
+            return sum < a || sum >= n ? sum - n : sum;
+        }
+
+        /// @brief a^exp в форме Монтгомери (a в форме Монтгомери)
+        uint64_t pow(uint64_t a, uint64_t exp) const {
+            uint64_t result = to_montgomery(1);
+            while (exp > 0) {
+                if (exp & 1) result = multiply(result, a);
+                a = square(a);
+                exp >>= 1;
+            }
+            return result;
+        }
+};
+
+/// @brief base^exp mod mod для любого mod > 0
+inline uint64_t pow_mod(uint64_t base, uint64_t exp, uint64_t mod) {
+    if (mod % 2 == 1) {
+        Montgomery64 mont(mod);
+        return mont.from_montgomery(mont.pow(mont.to_montgomery(base), exp));
+    }
+    uint64_t result = 1 % mod;
+    base %= mod;
+    while (exp > 0) {
+        if (exp & 1) result = static_cast<unsigned __int128>(result) * base % mod;
+        base = static_cast<unsigned __int128>(base) * base % mod;
+        exp >>= 1;
+    }
+    return result;
+}
+
+/// @brief Детерминированная проверка простоты для всех n < 2^64
+inline bool is_prime_u64(uint64_t n) {
+    static const uint64_t small_primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    if (n < 2) return false;
+    for (uint64_t p : small_primes) if (n % p == 0) return n == p;
+    if (n < 37 * 37) return true;
+
+    // n - 1 = d 2^s
+    int s = __builtin_ctzll(n - 1);
+    uint64_t d = (n - 1) >> s;
+    Montgomery64 mont(n);
+    const uint64_t one = mont.to_montgomery(1), minus_one = mont.to_montgomery(n - 1);
+
+    static const uint64_t bases[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+    for (uint64_t a : bases) {
+        if (a % n == 0) continue;
+        uint64_t x = mont.pow(mont.to_montgomery(a), d);
+        if (x == one || x == minus_one) continue;
+        bool witness = true;
+        for (int i = 1; i < s && witness; i++) {
+            x = mont.square(x);
+            if (x == minus_one) witness = false;
+        }
+        if (witness) return false;
+    }
+    return true;
+}
+
+/// @brief Нетривиальный делитель нечетного составного n (ро-метод Полларда, вариант Брента)
+///
+/// Разности накапливаются произведением по 128 штук, поэтому НОД считается редко;
+/// при перескоке (НОД = n) последний блок проходится заново по одной разности.
+inline uint64_t pollard_brent(uint64_t n) {
+    if (n % 2 == 0) return 2;
+    Montgomery64 mont(n);
+    const uint64_t block = 128;
+    for (uint64_t c = 1;; c++) {
+        const uint64_t cm = mont.to_montgomery(c);
+        auto f = [&](uint64_t x) { return mont.add(mont.square(x), cm); };
+        auto diff = [](uint64_t a, uint64_t b) { return a > b ? a - b : b - a; };
+
+        uint64_t x = 0, y = mont.to_montgomery(2), ys = y, product = mont.to_montgomery(1), g = 1;
+        for (uint64_t r = 1; g == 1; r <<= 1) {
+            x = y;
+            for (uint64_t i = 0; i < r; i++) y = f(y);
+            for (uint64_t k = 0; k < r && g == 1; k += block) {
+                ys = y;
+                for (uint64_t i = 0; i < std::min(block, r - k); i++) {
+                    y = f(y);
+                    product = mont.multiply(product, diff(x, y));
+                }
+                g = std::gcd(product, n); // R взаимно просто с n, форма Монтгомери НОД не меняет
+            }
+        }
+        if (g == n) {
+            do {
+                ys = f(ys);
+                g = std::gcd(diff(x, ys), n);
+            } while (g == 1);
+        }
+        if (g != n) return g;
+    }
+}
+
+/// @brief Различные простые делители n по возрастанию
+inline std::vector<uint64_t> prime_factors(uint64_t n) {
+    std::vector<uint64_t> factors;
+    for (uint64_t p = 2; p < 64 && p * p <= n; p++) {
+        if (n % p) continue;
+        factors.push_back(p);
+        while (n % p == 0) n /= p;
+    }
+    std::vector<uint64_t> stack;
+    if (n > 1) stack.push_back(n);
+    while (!stack.empty()) {
+        uint64_t m = stack.back();
+        stack.pop_back();
+        if (is_prime_u64(m)) {
+            factors.push_back(m);
+            continue;
+        }
+        uint64_t d = pollard_brent(m);
+        stack.push_back(d);
+        stack.push_back(m / d);
+    }
+    std::sort(factors.begin(), factors.end());
+    factors.erase(std::unique(factors.begin(), factors.end()), factors.end());
+    return factors;
+}
+
+/// @brief Наименьший первообразный корень по простому модулю p
+inline uint64_t primitive_root(uint64_t p) {
+    if (p == 2) return 1;
+    if (!is_prime_u64(p)) throw std::invalid_argument("primitive root modulus must be prime");
+    const uint64_t phi = p - 1;
+    std::vector<uint64_t> factors = prime_factors(phi);
+    Montgomery64 mont(p);
+    const uint64_t one = mont.to_montgomery(1);
+    for (uint64_t g = 2; g < p; g++) {
+        uint64_t gm = mont.to_montgomery(g);
+        bool root = std::none_of(factors.begin(), factors.end(), [&](uint64_t f) { return mont.pow(gm, phi / f) == one; });
+        if (root) return g;
+    }
+    return 0;
+}
@@ -6,329 +6,77 @@
 #include <chrono>
 #include <random>
 #include <cstdint>
-
-/// @brief  Объединенный LCG
-/// @param seed1 Начальное значение для 1 LCG
-/// @param k1 Коэффициент умножения для 1 LCG
-/// @param b1 Коэффициент смещения для 1 LCG
-/// @param m1 Модуль сравнения для 1 LCG
-/// @param seed2 Начальное значение для 2 LCG
-/// @param k2 Коэффициент умножения для 2 LCG
-/// @param b2 Коэффициент смещения для 2 LCG
-/// @param m2 Модуль сравнения для 2 LCG
-void LCG2(unsigned int& seed1, unsigned int k1, unsigned int b1, unsigned int m1, unsigned int& seed2, unsigned int k2, unsigned int b2, unsigned int m2) {
-    seed1 = (k1 * seed1 + b1) % m1;
-    seed2 = (k2 * seed2 + b2) % m2;
+#include <bit>
+#include <string>
+#include <csignal>
+#include <thread>
+#include "lcg_simd.h"
+#include "number_theory.h"
+#include "montgomery.h"
+#include "generators.h"
+#include "lcg_fixed.h"
+#include "statistics.h"
+#include "test_battery.h"
+#include "writers.h"
+#include "sweep.h"
+#include "generator_service.h"
+#include "../Common/profiler.h"
+
+
+/// @brief Вывод статистических параметров (среднее, отклонение, коэффициент вариации) и chi-статистики
+/// @param numbers Данные
+/// @param range Значения лежат в [0, range)
+void print_statistics(const std::vector<unsigned int>& numbers, uint64_t range) {
+    StreamStats stats(range, StreamStats::sturges_bins(numbers.size()));
+    stats.add(numbers);
+    std::cout << stats.mean() << ' ' << stats.stddev() << ' ' << stats.cv() << ' ';
+    std::cout << "\nChi-square statistic: " << stats.chi_square() << "\n";
 }
 
-/// @brief Получение данных для объединенного LCG
-/// @param N Необходимое количество генерируемых значений
-/// @param result  Вектор с результатом
-/// @param params Вектор параметров, необходимых для использования объединенного LCG
-void get_data(unsigned int N, std::vector<unsigned int>& result, std::vector<unsigned int>& params) {
-
-    // Инициализация генераторов
-    unsigned int s1 = 1;
-    unsigned int s2 = 1;
-    
-    unsigned int k1 = params[0];
-    unsigned int b1 = params[1];
-    unsigned int m1 = params[2];
-
-    unsigned int k2 = params[3];
-    unsigned int b2 = params[4];
-    unsigned int m2 = params[5];
-
-    for (int i = 1; i <= N; i++){
-        LCG2(s1, k1, b1, m1, s2, k2, b2, m2);
-        result.push_back(s1 ^ s2); //Возвращаю xor двух результатов
-    }
-
-}
-
-/// @brief Функция определения статистических параметров (среднее, отклонение, коэффициент вариации)
-/// @param data 
-/// @return Возвращает значение параметров в виде вектора
-std::vector<double> mean_st_cv(std::vector<unsigned int>& data){
-    
-    //Среднее
-    double sum = 0;
-    for (double value: data) sum += value;
-    double mean = sum / data.size();
-
-    //Отклонение
-    sum = 0;
-    for (double value: data) sum += (value - mean) * (value - mean);
-    double st = std::sqrt(sum / data.size());
-    
-    //Коэффициент вариации
-    double cv = st / mean;
-
-    std::vector<double> result = {mean, st, cv};
-    return result;
-   
-}
+int main(int argc, char** argv) {
 
-/// @brief Вычисление chi-статистики
-/// @param data Вектор данных
-/// @param N Размер данных
-/// @return 
-double chi(std::vector<unsigned int>& data, unsigned int N){
-    double k = 1.0 + std::log2(N); // применяем формулу
-    unsigned int bins = static_cast<unsigned int>(ceil(k));
-    double minVal = *std::min_element(data.begin(), data.end());
-    double maxVal = *std::max_element(data.begin(), data.end());
-    double range = maxVal - minVal;
-
-    std::vector<unsigned int> observed(bins, 0);
-    double binWidth = range / bins;
-
-    for (double value: data) {
-        int binIndex = static_cast<unsigned int>((value - minVal) / binWidth);
-        if (binIndex == bins) binIndex--;
-        observed[binIndex]++;
-    }
-    
-    double expectedFrequency = static_cast<double>(data.size()) / bins;
-    double chi = 0.0;
-    for (int count: observed) {
-        double diff = count - expectedFrequency;
-        chi += (diff * diff) / expectedFrequency;
+    //Потоковый режим: ./random_generator --raw bbs 2051719 4406159 182946 | dieharder -a -g 200
+    if (argc >= 3 && std::string(argv[1]) == "--raw") {
+        std::vector<unsigned long long> generator_params;
+        for (int i = 3; i < argc; i++) generator_params.push_back(std::stoull(argv[i]));
+        AnyGenerator generator = make_generator(argv[2], generator_params);
+        std::signal(SIGPIPE, SIG_IGN); //закрытый читателем канал - ошибка записи, а не завершение процесса
+        stream_raw(generator, std::bit_width(generator.max_value()), STDOUT_FILENO);
+        return 0;
     }
 
-    return chi;
-    
-}
-
-
-/// @brief Класс модифицированного генератора Блюм-Блюм-Шуба
-class BlumBlumShub {
-    public:
-        /// @brief Простое p
-        unsigned long long p; 
-        /// @brief Простое q
-        unsigned long long q;
-        /// @brief pq
-        unsigned long long n;
-        /// @brief Начальное значение
-        unsigned long long seed;
-        /// @brief Текущие состояние генератора
-        unsigned long long current;
-    
-        /// @brief Проверка, что число простое
-        bool is_prime(unsigned long long num) {
-            if (num <= 1) return false;
-            if (num == 2) return true;
-            if (num % 2 == 0) return false;
-            
-            unsigned long long sqrtNum = static_cast<unsigned long long>(std::sqrt(num)) + 1;
-            for (unsigned long long i=3; i < sqrtNum; i += 2) if (num % i == 0) return false;
-            return true;
-
-        }
-    
-        /// @brief Проверка на значение по модулю 3
-        bool is_3_mod_4(unsigned long long num) {
-            return (num % 4) == 3;
-        }
-    
+    //Перебор конфигураций из файла на пуле потоков: ./random_generator --sweep sweep.cfg [потоки]
+    if (argc >= 3 && std::string(argv[1]) == "--sweep") {
+        std::vector<SweepJob> jobs = read_sweep_config(argv[2]);
+        unsigned int threads = argc >= 4 ? std::stoul(argv[3]) : std::thread::hardware_concurrency();
 
-        BlumBlumShub(unsigned long long p, unsigned long long q, unsigned long long seed) {
-            
-            if (!is_prime(p) || !is_prime(q)) throw std::invalid_argument("p and q must be prime numbers");
-            if (!is_3_mod_4(p) || !is_3_mod_4(q)) throw std::invalid_argument("p and q must be congruent to 3 mod 4");
-            if (std::gcd(p, q) != 1) throw std::invalid_argument("p and q must be co-prime");
-            if (seed <= 1 || seed >= (p * q)) throw std::invalid_argument("seed must be in range (1, p*q)");
-    
-            this->p = p;
-            this->q = q;
-            this->n = p * q;
-            this->seed = seed;
-            this->current = (seed * seed) % n;
-        }
-        
-        /// @brief Генерация одного бита
-        bool next_bit() {
-            unsigned long long t = current % n;
-            current = t * t;
-            return current & 1; //Бит
-        }
-    
-        /// @brief Генерация следующего числа (bits = 13) 
-        unsigned long long next_number(int bits = 13) {
-            unsigned long long result = 0;
-            for (int i=0; i < bits; i++) result = (result << 1) | next_bit();
-            return result;
-        }
-};
-    
-
-/// @brief Функция, преобразующая 24 битное число (меняет половинки числа в битовом представлении местами)
-/// @param input 
-/// @return 
-unsigned int transform_24bit(unsigned int input) {
-    
-        const unsigned int abcdef_mask = 0b111111111111000000000000;
-        // const unsigned int g_mask = 0b0000001000000;     
-        const unsigned int hijklm_mask = 0b000000000000111111111111;
-        unsigned int abcdef = (input & abcdef_mask) >> 12;
-        //unsigned int g = (input & g_mask) >> 6;
-        unsigned int hijklm = input & hijklm_mask;
-        unsigned int result = (hijklm << 12) | abcdef;
-    
-        return result;
-    
-}
-
-/// @brief Модифицированный алгоритм Блюма-Микали
-class BlumMicaliGenerator {
-    public:
-        /// @brief Простое число p
-        unsigned long long p; 
-        /// @brief Первообразный корень по модулю p 
-        unsigned long long g; 
-        /// @brief Начальное значение
-        unsigned long long x0;
-        /// @brief Текущее состояние генератора
-        unsigned long long current;
-        
-        /// @brief Алгоритм проверки числа на простоту
-        /// @param num 
-        /// @return 
-        bool is_prime(unsigned long long num) {
-            if (num <= 1) return false;
-            if (num == 2) return true;
-            if (num % 2 == 0) return false;
-            
-            unsigned long long sqrtNum = static_cast<unsigned long long>(std::sqrt(num)) + 1;
-            for (unsigned long long i=3; i < sqrtNum; i += 2) if (num % i == 0) return false;
-            return true;
-        }
-        
-        /// @brief Поиск первообразных корней по простому модулю p
-        /// @param p Простое число - модуль
-        /// @return  Первый первообразный корень
-        unsigned long long find_primitive_root(unsigned long long p) {
-            if (p == 2) return 1;
-                
-            //Поиск множителей
-            unsigned long long phi = p - 1;
-            std::vector<unsigned long long> factors;
-            unsigned long long n = phi;
-            
-            for (unsigned long long i=2; i * i <= n; i++) {
-                if (n % i == 0) {
-                    factors.push_back(i);
-                    while (n % i == 0) n /= i;
-                }
-            }
-
-            if (n > 1) factors.push_back(n);
-
-            for (unsigned long long g = 2; g <= p; g++) {
-                bool flag = true;
-                for (unsigned long long f: factors) {
-                    if (modular_pow(g, phi / f, p) == 1) {
-                        flag = false;
-                        break;
-                    }
-                }
-
-                if (flag) return g;
-            }
+        ProfileScope sweep_scope("sweep");
+        auto start_time = std::chrono::high_resolution_clock::now();
+        std::vector<SweepResult> results = run_sweep(jobs, threads);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        sweep_scope.finish();
+        std::chrono::duration<double, std::milli> duration = end_time - start_time;
 
-            return 0;
-        }
-        
-        /// @brief Алгоритм быстрого возведения в степень по модулю
-        /// @param base основание степени
-        /// @param exp  значение степени
-        /// @param mod  модуль
-        /// @return 
-        unsigned long long modular_pow(unsigned long long base, unsigned long long exp, unsigned long long mod) {
-            unsigned long long result = 1;
-            base %= mod;
-            while (exp > 0) {
-                if (exp % 2 == 1) result = (result * base) % mod;
-                exp >>= 1;
-                base = (base * base) % mod;
+        double total = 0, slowest = 0;
+        for (size_t i = 0; i < jobs.size(); i++) {
+            std::cout << jobs[i].prefix << "_" << jobs[i].index << " Parametres: ";
+            for (unsigned long long param : jobs[i].params) std::cout << param << ' ';
+            if (!results[i].error.empty()) {
+                std::cout << "\nОшибка: " << results[i].error << "\n\n";
+                continue;
             }
-            return result;
-        }
-
-        BlumMicaliGenerator(unsigned long long prime) : p(prime) {
-            if (!is_prime(p)) throw std::invalid_argument("Provided number must be a prime");
-
-            g = find_primitive_root(p);
-            x0 = 19270 % p; //Задаю seed одинаковый здесь
-            current = x0;
-        }
-
-        /// @brief Генерация следующего бита
-        /// @return 
-        bool next_bit() {
-            current = modular_pow(g, current, p);
-            return current > (p - 1) / 2;
-        }
-        /// @brief Генерация следующего 24 битного числа
-        /// @return 
-        unsigned int next_number() {
-            unsigned int result = 0;
-            for (int i=0; i < 24; i++) result = (result << 1) | next_bit();
-            return result;
-        }
-        
-        void generate(std::vector<unsigned int>& output, size_t count) {
-            
-            for (size_t i=0; i < count; i++) output.push_back(transform_24bit(next_number()));
-            
+            std::cout << "\nStatistical data (mean, std, CV): " << results[i].mean << ' ' << results[i].stddev << ' ' << results[i].cv << ' ';
+            std::cout << "\nChi-square statistic: " << results[i].chi_square << "\n";
+            std::cout << "Время: " << results[i].milliseconds << " ms\n\n";
+            total += results[i].milliseconds;
+            slowest = std::max(slowest, results[i].milliseconds);
         }
-};
-
-
-/// @brief Запись в файл сгенерированных чисел
-/// @param filename Имя файла записи
-/// @param numbers Массив данных
-void write_numbers_file(const std::string& filename, const std::vector<unsigned int>& numbers) {
-    std::ofstream file(filename);
-    
-    if (!file.is_open()) {
-        std::cerr << "Не удалось открыть файл " << filename << " для записи." << std::endl;
-        return;
+        std::cout << "Конфигураций: " << jobs.size() << ", потоков: " << threads << ", время перебора: " << duration.count()
+                  << " ms (генерация: сумма " << total << " ms, самая долгая " << slowest << " ms)\n";
+        print_profile_report();
+        return 0;
     }
     
-    for (int num: numbers) file << num << "\n";
-    
-    file.close();
-}
-
-/// @brief Запись в файл чисел в бинарном представлении
-/// @param filename Имя файла записи
-/// @param result Массив данных
-void write_bin_file(const std::string& filename, const std::vector<unsigned int>& result) {
-    
-    std::ofstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Не удалось открыть файл " << filename << " для записи." << std::endl;
-        return;
-    }
-    
-    for (unsigned int num: result) {
-       
-        uint8_t byte1 = (num >> 16) & 0b11111111;
-        uint8_t byte2 = (num >> 8)  & 0b11111111;
-        uint8_t byte3 = num         & 0b11111111; 
-
-        file.write(reinterpret_cast<const char*>(&byte1), 1);
-        file.write(reinterpret_cast<const char*>(&byte2), 1);
-        file.write(reinterpret_cast<const char*>(&byte3), 1);
-    }
-    
-    file.close();
-}
-
-int main() {
-    
     std::cout << "Тестирование генератора №1" << "\n\n";
     //Данные первого генератора
     std::vector<std::vector<unsigned int>> res_vec(20);
@@ -363,27 +111,53 @@ int main() {
     
     };
     
-    std::vector<double> d;
     for (int i=0; i < 20; i++){
         std::cout << "Parametres: ";
         for (int k=0; k < 6; k++) std::cout << params[i][k] << ' ';
         std::cout << "\nStatistical data (mean, std, CV): ";
 
+        ProfileScope simd_scope("lcg simd");
         auto start_time = std::chrono::high_resolution_clock::now();
-        get_data(100000, res_vec[i], params[i]);
+        get_data_simd(100000, res_vec[i], params[i]); // та же последовательность, что и get_data()
         auto end_time = std::chrono::high_resolution_clock::now();
+        simd_scope.finish();
         std::chrono::duration<double, std::milli> duration = end_time - start_time;
         
         //Запись в бинарный файл и числа
         std::string filename1 = "LCG_" + std::to_string(i) + ".bin";
         std::string filename2 = "LCG_num_" + std::to_string(i) + ".txt";
 
-        write_bin_file(filename1, res_vec[i]);
-        write_numbers_file(filename2, res_vec[i]);
+        {
+            ProfileScope scope("write files");
+            write_bin_file(filename1, res_vec[i]);
+            write_numbers_file(filename2, res_vec[i]);
+        }
         
-        d = mean_st_cv(res_vec[i]);
-        for (int j=0; j < 3; j++) std::cout << d[j] << ' ';
-        std::cout << "\nChi-square statistic: " << chi(res_vec[i], 100000) << "\n\n";
+        {
+            ProfileScope scope("statistics");
+            print_statistics(res_vec[i], std::bit_ceil(std::max(params[i][2], params[i][5]))); //s1 ^ s2 < 2^k >= max(m1, m2)
+        }
+
+        //Сравнение с общим путем: get_data() (деление на m во время работы) и специализация с постоянными модулями
+        std::vector<unsigned int> generic, fixed;
+        ProfileScope generic_scope("lcg get_data");
+        start_time = std::chrono::high_resolution_clock::now();
+        get_data(100000, generic, params[i]);
+        end_time = std::chrono::high_resolution_clock::now();
+        generic_scope.finish();
+        std::chrono::duration<double, std::milli> generic_duration = end_time - start_time;
+
+        ProfileScope fixed_scope("lcg fixed");
+        start_time = std::chrono::high_resolution_clock::now();
+        get_data_dispatch(100000, fixed, params[i]);
+        end_time = std::chrono::high_resolution_clock::now();
+        fixed_scope.finish();
+        std::chrono::duration<double, std::milli> fixed_duration = end_time - start_time;
+
+        std::cout << "Время: " << duration.count() << " ms (SIMD), " << fixed_duration.count() << " ms (шаблон), "
+                  << generic_duration.count() << " ms (get_data), ускорение шаблона: " << generic_duration / fixed_duration
+                  << (fixed == generic ? "" : " (последовательности различаются!)") << "\n";
+        std::cout << "\n";
 
     }
     
@@ -400,30 +174,49 @@ int main() {
         for (int ind2=0; ind2<4; ind2++){
 
             BlumBlumShub bbs(primes1[ind1], primes2[ind2], seed);
-            std::vector<unsigned int> numbers;
+            std::vector<unsigned int> old_numbers;
             
+            ProfileScope legacy_scope("bbs legacy");
             auto start_time = std::chrono::high_resolution_clock::now();
             for (int i = 0; i < 100000; i++){
                 c1 = bbs.next_number(24);
                 c2 =  bbs.next_number(24);
-                numbers.push_back(c1 ^ c2); //xor
+                old_numbers.push_back(c1 ^ c2); //xor
             } 
             auto end_time = std::chrono::high_resolution_clock::now();
+            legacy_scope.finish();
+            std::chrono::duration<double, std::milli> old_duration = end_time - start_time;
+
+            //BBS на арифметике Монтгомери: без переполнения x^2 и несколько бит с одного возведения в квадрат
+            BBSEngine fast_bbs(primes1[ind1], primes2[ind2], seed); //c1 ^ c2 внутри движка
+            std::vector<unsigned int> numbers(100000);
+
+            ProfileScope fast_scope("bbs montgomery");
+            start_time = std::chrono::high_resolution_clock::now();
+            fast_bbs.fill(numbers);
+            end_time = std::chrono::high_resolution_clock::now();
+            fast_scope.finish();
             std::chrono::duration<double, std::milli> duration = end_time - start_time;
         
             //Запись в бинарный файл и числа
             std::string filename1 = "BBS_" + std::to_string(ind1 * 4 + ind2) + ".bin";
             std::string filename2 = "BBS_num_" + std::to_string(ind1 * 4 + ind2) + ".txt";
 
-            write_bin_file(filename1, numbers);
-            write_numbers_file(filename2, numbers);
+            {
+                ProfileScope scope("write files");
+                write_bin_file(filename1, numbers);
+                write_numbers_file(filename2, numbers);
+            }
 
             std::cout << "Parametres: p = " << primes1[ind1] << ", q = " << primes2[ind2];
             std::cout << "\nStatistical data (mean, std, CV): ";
-            d = mean_st_cv(numbers);
-            for (int j=0; j < 3; j++) std::cout << d[j] << ' ';
-            std::cout << "\nChi-square statistic: " << chi(numbers, 100000) << "\n";
-            std::cout << "Время: " << duration.count() << " ms\n\n";
+            {
+                ProfileScope scope("statistics");
+                print_statistics(numbers, uint64_t(BBSEngine::max()) + 1);
+            }
+            std::cout << "Время: " << duration.count() << " ms\n";
+            std::cout << "Чисел в секунду: " << numbers.size() / (duration.count() / 1000) << " (Монтгомери, "
+                      << fast_bbs.bits_per_step() << " бит за шаг), " << old_numbers.size() / (old_duration.count() / 1000) << " (исходный BBS)\n\n";
         }
     }
     
@@ -439,31 +232,86 @@ int main() {
         277905127, 65775247, 16805119, 4710187, 1743823};
     
     for (int i=0; i < 20; i++){
-        BlumMicaliGenerator bmg(primes3[i]);
-        std::vector<unsigned int> numbers;
+        BlumMicaliEngine bmg(primes3[i]);
+        std::vector<unsigned int> numbers(100000);
         
         //Замер времени
+        ProfileScope bm_scope("bm");
         auto start_time = std::chrono::high_resolution_clock::now();
-        bmg.generate(numbers, 100000);
+        bmg.fill(numbers);
         auto end_time = std::chrono::high_resolution_clock::now();
+        bm_scope.finish();
         std::chrono::duration<double, std::milli> duration = end_time - start_time;
         
         //Запись в бинарный файл и числа
         std::string filename1 = "BM_" + std::to_string(i) + ".bin";
         std::string filename2 = "BM_num_" + std::to_string(i) + ".txt";
 
-        write_bin_file(filename1, numbers);
-        write_numbers_file(filename2, numbers);
+        {
+            ProfileScope scope("write files");
+            write_bin_file(filename1, numbers);
+            write_numbers_file(filename2, numbers);
+        }
 
         std::cout << "\nParam: p = " << primes3[i] << '\n';
         std::cout << "Statistical data (mean, std, CV): ";
-        d = mean_st_cv(numbers);
-        for (int j=0; j < 3; j++) std::cout << d[j] << ' ';
-        std::cout << "\nChi-square statistic: " << chi(numbers, 100000) << "\n";
+        {
+            ProfileScope scope("statistics");
+            print_statistics(numbers, uint64_t(BlumMicaliEngine::max()) + 1);
+        }
         std::cout << "Время: " << duration.count() << " ms\n\n";
     }
         
-    //Замер времени
+    //Тестовая батарея: числа идут из генератора прямо в тесты, без файлов
+    std::cout << "Тестовая батарея (1000000 чисел)" << "\n\n";
+    std::vector<std::pair<std::string, std::vector<unsigned long long>>> battery_generators = {
+        {"lcg", {905, 582, 8191, 2701, 27, 8191}},
+        {"bbs", {2051719, 4406159, 182946}},
+        {"bm", {902626523}},
+        {"mt19937", {5489}},
+    };
+    for (const auto& [name, generator_params] : battery_generators) {
+        AnyGenerator generator = make_generator(name, generator_params);
+        ProfileScope battery_scope("battery " + name);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        std::vector<TestResult> results = run_battery(generator, 1000000, std::bit_width(generator.max_value()));
+        auto end_time = std::chrono::high_resolution_clock::now();
+        battery_scope.finish();
+        std::chrono::duration<double, std::milli> duration = end_time - start_time;
+
+        std::cout << "Generator: " << name << ", время: " << duration.count() << " ms\n";
+        for (const TestResult& result : results) std::cout << "  " << result.name << ": statistic " << result.statistic << ", p-value " << result.p_value << "\n";
+        std::cout << "\n";
+    }
+
+    //Сервис генераторов: производители BM заполняют кольца блоков заранее, потребители забирают блоки без блокировок
+    std::cout << "Сервис генераторов (BM, 2 производителя, 2 потребителя)" << "\n\n";
+    {
+        ProfileScope service_scope("service");
+        GeneratorService service([](unsigned int producer) { return make_stream_generator("bm", {902626523}, producer); }, 2, 4096, 8);
+        std::vector<std::thread> consumers;
+        std::vector<StreamStats> consumer_stats(2, StreamStats(uint64_t(BlumMicaliEngine::max()) + 1, 64));
+        for (int c = 0; c < 2; c++) {
+            consumers.emplace_back([&, c] {
+                std::vector<uint32_t> block(service.block_size);
+                for (int k = 0; k < 25 && service.take(block); k++) consumer_stats[c].add(block);
+            });
+        }
+        for (std::thread& consumer : consumers) consumer.join();
+        ServiceStats stats = service.stats();
+        service.stop();
+        service_scope.finish();
+
+        consumer_stats[0].merge(consumer_stats[1]);
+        std::cout << "Получено чисел: " << consumer_stats[0].count() << ", среднее: " << consumer_stats[0].mean()
+                  << ", ожиданий пустых колец: " << stats.empty_waits << ", заполнение колец: " << stats.fill_ratio() << "\n";
+        for (const ProducerStats& p : stats.producers)
+            std::cout << "  Производитель: блоков " << p.blocks_produced << ", отдано " << p.blocks_consumed << ", в кольце " << p.fill << "/" << p.capacity
+                      << ", кольцо было полно " << p.full_waits << " раз, генерация " << p.generate_ms << " ms\n";
+        std::cout << "\n";
+    }
+
+    //Замер времени (нс на число, МБ/с и масштабирование по потокам для всех генераторов - benchmark.cpp)
 
     std::vector<unsigned int> times = {1000, 1635, 2859, 5000, 8743, 15289, 26736, 46753, 81756, 142965, 250000, 384000, 500000, 650000, 830000, 910000, 1000000};
     for (int i=0; i < 17; i++){
@@ -477,6 +325,7 @@ int main() {
 
         std::vector<unsigned int> numbers;
 
+        ProfileScope timing_scope("timing loop");
         auto start_time = std::chrono::high_resolution_clock::now();
         /*for (int j = 0; j < times[i]; j++){
             c1 = bbs.next_number(24);
@@ -487,13 +336,20 @@ int main() {
         //bmg.generate(numbers, times[i]);
 
         //get_data(times[i], numbers, params[10]);
+        //numbers.resize(times[i]); SimdCombinedLCG(params[10]).fill(numbers.data(), times[i]);
+        //get_data_parallel(times[i], numbers, params[10]);
+        
+        //Любой генератор по имени из реестра, блочное заполнение
+        //numbers.resize(times[i]); make_generator("bbs", {2051719, 4406159, 182946}).fill(numbers);
         
         for (int j=0; j < times[i]; j++) numbers.push_back(distrib(gen));
         
         auto end_time = std::chrono::high_resolution_clock::now();
+        timing_scope.finish();
         std::chrono::duration<double, std::milli> duration = end_time - start_time;
         std::cout << "Количество элементов:" << times[i] << " Время: " << duration.count() << " ms\n\n";
     }
     
+    print_profile_report();
     return 0;
 }
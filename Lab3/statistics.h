@@ -0,0 +1,167 @@
+#include <vector>
+#include <span>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/// @file statistics.h
+/// @brief Потоковая статистика за один проход: среднее, отклонение, CV и хи-квадрат
+///
+/// Значения не хранятся: блок обрабатывается в кэше (сумма, сумма квадратов отклонений,
+/// гистограмма) и сливается с накопленным состоянием формулой Чана (обобщение Уэлфорда).
+/// Состояния, посчитанные независимо (например, разными потоками), сливаются той же формулой.
+/// Подключается после generators.h.
+
+class StreamStats {
+    public:
+        /// @param range Значения лежат в [0, range)
+        /// @param bins Желаемое число интервалов гистограммы; ширина интервала округляется
+        /// вверх до степени двойки, поэтому номер интервала - сдвиг, а не деление
+        StreamStats(uint64_t range, unsigned int bins) : range(range) {
+            if (range == 0 || bins == 0) throw std::invalid_argument("range and bins must be positive");
+            uint64_t width = (range + bins - 1) / bins;
+            while ((uint64_t(1) << shift) < width) shift++;
+            bin_count = static_cast<unsigned int>(((range - 1) >> shift) + 1);
+            counts.assign(size_t(copies) * bin_count, 0);
+        }
+
+        /// @brief Число интервалов по правилу Стёрджеса: ceil(1 + log2 N)
+        static unsigned int sturges_bins(uint64_t count) {
+            return static_cast<unsigned int>(std::ceil(1.0 + std::log2(static_cast<double>(std::max<uint64_t>(count, 1)))));
+        }
+
+        /// @brief Добавление одного значения
+        void add(uint32_t value) { add(std::span<const uint32_t>(&value, 1)); }
+
+        /// @brief Добавление блока значений
+        void add(std::span<const uint32_t> block) {
+            if (block.empty()) return;
+
+            // Блок: сумма, затем сумма квадратов отклонений от среднего блока (данные в кэше)
+            double sum = 0;
+            uint32_t lo = block[0], hi = block[0];
+            for (uint32_t value : block) {
+                sum += value;
+                lo = std::min(lo, value);
+                hi = std::max(hi, value);
+            }
+            if (hi >= range) throw std::out_of_range("value is outside of the histogram range");
+            double block_mean = sum / block.size();
+            double block_m2 = 0;
+            for (uint32_t value : block) block_m2 += (value - block_mean) * (value - block_mean);
+            histogram(block);
+            merge_moments(block.size(), block_mean, block_m2);
+            min_value = std::min(min_value, lo);
+            max_value = std::max(max_value, hi);
+        }
+
+        /// @brief count значений из генератора блоками по block (память не зависит от count)
+        template <NumberGenerator G>
+        void consume(G& generator, uint64_t count, size_t block = 4096) {
+            std::vector<uint32_t> buffer(block);
+            while (count > 0) {
+                size_t n = static_cast<size_t>(std::min<uint64_t>(count, block));
+                std::span<uint32_t> part(buffer.data(), n);
+                generator.fill(part);
+                add(part);
+                count -= n;
+            }
+        }
+
+        /// @brief Слияние с состоянием по другой части потока (та же гистограмма)
+        void merge(const StreamStats& other) {
+            if (other.range != range || other.shift != shift) throw std::invalid_argument("statistics with different histograms");
+            for (size_t i = 0; i < counts.size(); i++) counts[i] += other.counts[i];
+            if (other.n == 0) return;
+            merge_moments(other.n, other.mean_value, other.m2);
+            min_value = std::min(min_value, other.min_value);
+            max_value = std::max(max_value, other.max_value);
+        }
+
+        uint64_t count() const { return n; }
+        double mean() const { return mean_value; }
+        /// @brief Дисперсия генеральной совокупности (деление на N, как в mean_st_cv)
+        double variance() const { return n ? m2 / n : 0; }
+        double stddev() const { return std::sqrt(variance()); }
+        /// @brief Коэффициент вариации
+        double cv() const { return stddev() / mean_value; }
+        uint32_t min() const { return min_value; }
+        uint32_t max() const { return max_value; }
+        unsigned int bins() const { return bin_count; }
+
+        /// @brief Частота интервала i
+        uint64_t observed(unsigned int i) const {
+            uint64_t result = 0;
+            for (int c = 0; c < copies; c++) result += counts[size_t(c) * bin_count + i];
+            return result;
+        }
+
+        /// @brief Статистика хи-квадрат против равномерного распределения на [0, range);
+        /// ожидаемая частота интервала пропорциональна его ширине (последний может быть уже)
+        double chi_square() const {
+            double chi = 0;
+            for (unsigned int i = 0; i < bin_count; i++) {
+                uint64_t begin = uint64_t(i) << shift, end = std::min(range, uint64_t(i + 1) << shift);
+                double expected = double(n) * (end - begin) / range;
+                double diff = observed(i) - expected;
+                chi += diff * diff / expected;
+            }
+            return chi;
+        }
+
+    private:
+        /// @brief Копии гистограммы: соседние значения попадают в разные копии, и
+        /// инкременты одного интервала не ждут друг друга
+        static const int copies = 4;
+
+        uint64_t range;
+        int shift = 0;
+        unsigned int bin_count = 0;
+        std::vector<uint64_t> counts;
+
+        uint64_t n = 0;
+        double mean_value = 0;
+        /// @brief Сумма квадратов отклонений от среднего
+        double m2 = 0;
+        uint32_t min_value = UINT32_MAX;
+        uint32_t max_value = 0;
+
+        /// @brief Формула Чана: слияние (n, mean, M2) двух частей
+        void merge_moments(uint64_t other_n, double other_mean, double other_m2) {
+            uint64_t total = n + other_n;
+            double delta = other_mean - mean_value;
+            mean_value += delta * other_n / total;
+            m2 += other_m2 + delta * delta * (double(n) * other_n / total);
+            n = total;
+        }
+
+        void histogram(std::span<const uint32_t> block) {
+            uint64_t* c0 = counts.data();
+            uint64_t* c1 = c0 + bin_count;
+            uint64_t* c2 = c1 + bin_count;
+            uint64_t* c3 = c2 + bin_count;
+            size_t i = 0;
+#ifdef __AVX2__
+            // Номера интервалов 8 значений одним сдвигом
+            alignas(32) uint32_t index[8];
+            const __m128i count = _mm_cvtsi32_si128(shift);
+            for (; i + 8 <= block.size(); i += 8) {
+                __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block.data() + i));
+                _mm256_store_si256(reinterpret_cast<__m256i*>(index), _mm256_srl_epi32(values, count));
+                c0[index[0]]++; c1[index[1]]++; c2[index[2]]++; c3[index[3]]++;
+                c0[index[4]]++; c1[index[5]]++; c2[index[6]]++; c3[index[7]]++;
+            }
+#endif
+            for (; i + 4 <= block.size(); i += 4) {
+                c0[block[i] >> shift]++;
+                c1[block[i + 1] >> shift]++;
+                c2[block[i + 2] >> shift]++;
+                c3[block[i + 3] >> shift]++;
+            }
+            for (; i < block.size(); i++) c0[block[i] >> shift]++;
+        }
+};
@@ -0,0 +1,158 @@
+#include <vector>
+#include <string>
+#include <map>
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <exception>
+#include <cctype>
+#include <bit>
+
+/// @file sweep.h
+/// @brief Параллельный перебор конфигураций генераторов из файла
+///
+/// Конфигурации независимы, поэтому выполняются пулом потоков. Стоимость каждой оценивается
+/// пробной генерацией, и задачи раздаются от самой дорогой к самой дешевой (LPT): свободный
+/// поток берет следующую по стоимости, и долгие задачи BM не остаются в конце очереди.
+/// Результаты хранятся по номеру конфигурации и печатаются в порядке файла.
+/// Подключается после statistics.h и writers.h.
+
+/// @brief Одна конфигурация перебора
+struct SweepJob {
+    std::string generator;
+    std::vector<unsigned long long> params;
+    /// @brief Сколько чисел сгенерировать
+    size_t count = 100000;
+    /// @brief Префикс файлов результата: <prefix>_<index>.bin и <prefix>_num_<index>.txt
+    std::string prefix;
+    int index = 0;
+};
+
+/// @brief Результат конфигурации
+struct SweepResult {
+    double mean = 0, stddev = 0, cv = 0, chi_square = 0;
+    double milliseconds = 0;
+    /// @brief Пусто, если конфигурация выполнена
+    std::string error;
+};
+
+/// @brief Чтение сетки параметров
+///
+/// Строка - конфигурация: "<генератор> <параметры...>" (имена из generator_registry()).
+/// "count N" задает число чисел для следующих строк, '#' начинает комментарий.
+/// Файлы нумеруются отдельно для каждого генератора: LCG_0, LCG_1, ..., BBS_0, ...
+inline std::vector<SweepJob> read_sweep_config(std::istream& in) {
+    std::vector<SweepJob> jobs;
+    std::map<std::string, int> next_index;
+    size_t count = 100000;
+    std::string line;
+    for (int line_number = 1; std::getline(in, line); line_number++) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name)) continue;
+
+        std::vector<unsigned long long> values;
+        unsigned long long value;
+        while (fields >> value) values.push_back(value);
+        if (!fields.eof()) throw std::invalid_argument("sweep config line " + std::to_string(line_number) + ": expected numbers");
+
+        if (name == "count") {
+            if (values.size() != 1 || values[0] == 0) throw std::invalid_argument("sweep config line " + std::to_string(line_number) + ": count needs one positive value");
+            count = values[0];
+            continue;
+        }
+        if (!generator_registry().count(name)) throw std::invalid_argument("sweep config line " + std::to_string(line_number) + ": unknown generator " + name);
+
+        SweepJob job{name, values, count, name, next_index[name]++};
+        std::transform(job.prefix.begin(), job.prefix.end(), job.prefix.begin(), [](unsigned char c) { return std::toupper(c); });
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+inline std::vector<SweepJob> read_sweep_config(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) throw std::invalid_argument("cannot open sweep config " + filename);
+    return read_sweep_config(file);
+}
+
+/// @brief Значения конфигурации лежат в [0, range): у LCG это 2^k >= max(m1, m2), у остальных max() + 1
+inline uint64_t sweep_value_range(const SweepJob& job, const AnyGenerator& generator) {
+    if (job.generator == "lcg" && job.params.size() == 6) return std::bit_ceil(std::max(job.params[2], job.params[5]));
+    return uint64_t(generator.max_value()) + 1;
+}
+
+/// @brief Оценка стоимости: время пробной генерации sample чисел, умноженное на count / sample
+inline double estimate_sweep_cost(const SweepJob& job, size_t sample = 2048) {
+    AnyGenerator generator = make_generator(job.generator, job.params);
+    std::vector<uint32_t> buffer(std::min(sample, job.count));
+    auto start_time = std::chrono::steady_clock::now();
+    generator.fill(buffer);
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_time;
+    return duration.count() * job.count / buffer.size();
+}
+
+/// @brief Выполнение одной конфигурации: генерация, запись файлов, статистика
+/// @param write_files False - без записи файлов (замер только генерации и статистики)
+inline SweepResult run_sweep_job(const SweepJob& job, bool write_files = true) {
+    SweepResult result;
+    try {
+        AnyGenerator generator = make_generator(job.generator, job.params);
+        std::vector<unsigned int> numbers(job.count);
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        generator.fill(numbers);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        result.milliseconds = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+
+        if (write_files) {
+            write_bin_file(job.prefix + "_" + std::to_string(job.index) + ".bin", numbers);
+            write_numbers_file(job.prefix + "_num_" + std::to_string(job.index) + ".txt", numbers);
+        }
+
+        StreamStats stats(sweep_value_range(job, generator), StreamStats::sturges_bins(numbers.size()));
+        stats.add(numbers);
+        result.mean = stats.mean();
+        result.stddev = stats.stddev();
+        result.cv = stats.cv();
+        result.chi_square = stats.chi_square();
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    return result;
+}
+
+/// @brief Выполнение всех конфигураций на threads потоках в порядке убывания оценки стоимости
+/// @return Результаты в порядке jobs
+inline std::vector<SweepResult> run_sweep(const std::vector<SweepJob>& jobs, unsigned int threads = std::thread::hardware_concurrency(), bool write_files = true) {
+    std::vector<double> cost(jobs.size(), 0);
+    for (size_t i = 0; i < jobs.size(); i++) {
+        try {
+            cost[i] = estimate_sweep_cost(jobs[i]);
+        } catch (const std::exception&) {
+            // Ошибку параметров сообщит run_sweep_job
+        }
+    }
+    std::vector<size_t> order(jobs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return cost[a] > cost[b]; });
+
+    std::vector<SweepResult> results(jobs.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t k = next++; k < order.size(); k = next++) results[order[k]] = run_sweep_job(jobs[order[k]], write_files);
+    };
+
+    threads = std::max(1u, std::min<unsigned int>(threads, static_cast<unsigned int>(jobs.size())));
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (std::thread& thread : pool) thread.join();
+    return results;
+}
@@ -0,0 +1,372 @@
+#include <vector>
+#include <string>
+#include <span>
+#include <memory>
+#include <thread>
+#include <barrier>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+/// @file test_battery.h
+/// @brief Набор статистических тестов, который читает числа прямо из генератора, без файлов
+///
+/// Генератор заполняет блоки (двойной буфер), тесты распределены по потокам и читают
+/// один и тот же блок, пока генератор пишет следующий. Каждый тест накапливает свою
+/// статистику потоково и в конце выдает p-значение. Подключается после generators.h.
+
+/// @brief Верхняя регуляризованная неполная гамма-функция Q(a, x) (p-значение хи-квадрат: Q(df/2, chi/2))
+inline double igamc(double a, double x) {
+    if (x <= 0) return 1;
+    double log_prefix = a * std::log(x) - x - std::lgamma(a);
+    if (x < a + 1) {
+        // Ряд для P(a, x)
+        double term = 1 / a, sum = term;
+        for (int n = 1; n < 1000 && std::fabs(term) > std::fabs(sum) * 1e-15; n++) {
+            term *= x / (a + n);
+            sum += term;
+        }
+        return std::max(0.0, 1 - sum * std::exp(log_prefix));
+    }
+    // Цепная дробь Лентца для Q(a, x)
+    const double tiny = 1e-300;
+    double b = x + 1 - a, c = 1 / tiny, d = 1 / b, h = d;
+    for (int i = 1; i < 1000; i++) {
+        double an = -i * (i - a);
+        b += 2;
+        d = an * d + b;
+        if (std::fabs(d) < tiny) d = tiny;
+        c = b + an / c;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1) < 1e-15) break;
+    }
+    return std::exp(log_prefix) * h;
+}
+
+/// @brief Двустороннее p-значение для стандартной нормальной статистики z
+inline double normal_p_value(double z) { return std::erfc(std::fabs(z) / std::sqrt(2.0)); }
+
+/// @brief Хи-квадрат наблюдаемых частот против ожидаемых вероятностей
+inline double chi_square(const std::vector<uint64_t>& observed, const std::vector<double>& probability, uint64_t total) {
+    double chi = 0;
+    for (size_t i = 0; i < observed.size(); i++) {
+        double expected = total * probability[i];
+        chi += (observed[i] - expected) * (observed[i] - expected) / expected;
+    }
+    return chi;
+}
+
+/// @brief Результат теста
+struct TestResult {
+    std::string name;
+    double statistic;
+    double p_value;
+};
+
+/// @brief Потоковый тест: блоки приходят по порядку, из одного потока
+class BatteryTest {
+    public:
+        /// @param bits Число значащих бит в числе генератора
+        explicit BatteryTest(int bits) : bits(bits) {}
+        virtual ~BatteryTest() = default;
+        virtual void consume(std::span<const uint32_t> block) = 0;
+        virtual TestResult result() const = 0;
+
+    protected:
+        int bits;
+};
+
+/// @brief Частотный тест: доля единиц во всех битах
+class MonobitTest : public BatteryTest {
+    public:
+        using BatteryTest::BatteryTest;
+
+        void consume(std::span<const uint32_t> block) override {
+            for (uint32_t value : block) ones += std::popcount(value);
+            total_bits += uint64_t(bits) * block.size();
+        }
+
+        TestResult result() const override {
+            double s = 2.0 * ones - double(total_bits);
+            return {"monobit", s, std::erfc(std::fabs(s) / std::sqrt(2.0 * total_bits))};
+        }
+
+    private:
+        uint64_t ones = 0, total_bits = 0;
+};
+
+/// @brief Частотный тест в блоках по 8 чисел (M = 8 bits бит)
+class BlockFrequencyTest : public BatteryTest {
+    public:
+        using BatteryTest::BatteryTest;
+
+        void consume(std::span<const uint32_t> block) override {
+            for (uint32_t value : block) {
+                block_ones += std::popcount(value);
+                if (++in_block == numbers_per_block) {
+                    double pi = double(block_ones) / (numbers_per_block * bits);
+                    sum += (pi - 0.5) * (pi - 0.5);
+                    blocks++;
+                    block_ones = 0;
+                    in_block = 0;
+                }
+            }
+        }
+
+        TestResult result() const override {
+            double chi = 4.0 * numbers_per_block * bits * sum;
+            return {"block frequency", chi, igamc(blocks / 2.0, chi / 2)};
+        }
+
+    private:
+        static const int numbers_per_block = 8;
+        uint64_t blocks = 0;
+        int block_ones = 0, in_block = 0;
+        double sum = 0;
+};
+
+/// @brief Тест серий: число серий одинаковых бит в битовом потоке
+class RunsTest : public BatteryTest {
+    public:
+        using BatteryTest::BatteryTest;
+
+        void consume(std::span<const uint32_t> block) override {
+            const uint32_t pair_mask = bits == 32 ? 0x7FFFFFFFu : (1u << (bits - 1)) - 1;
+            for (uint32_t value : block) {
+                ones += std::popcount(value);
+                transitions += std::popcount((value ^ (value >> 1)) & pair_mask); // соседние биты внутри числа
+                uint32_t first = (value >> (bits - 1)) & 1;
+                if (total_bits > 0 && first != last_bit) transitions++;             // стык с предыдущим числом
+                last_bit = value & 1;
+                total_bits += bits;
+            }
+        }
+
+        TestResult result() const override {
+            double n = double(total_bits), pi = ones / n;
+            if (std::fabs(pi - 0.5) >= 2 / std::sqrt(n)) return {"runs", double(transitions + 1), 0}; // монобит не пройден
+            double v = double(transitions + 1);
+            return {"runs", v, std::erfc(std::fabs(v - 2 * n * pi * (1 - pi)) / (2 * std::sqrt(2 * n) * pi * (1 - pi)))};
+        }
+
+    private:
+        uint64_t ones = 0, transitions = 0, total_bits = 0;
+        uint32_t last_bit = 0;
+};
+
+/// @brief Покер-тест: частоты 4-битных групп числа (16 категорий)
+class PokerTest : public BatteryTest {
+    public:
+        using BatteryTest::BatteryTest;
+
+        void consume(std::span<const uint32_t> block) override {
+            int hands = bits / 4;
+            for (uint32_t value : block)
+                for (int h = 0; h < hands; h++) counts[(value >> (bits - 4 * (h + 1))) & 15]++;
+            total += uint64_t(hands) * block.size();
+        }
+
+        TestResult result() const override {
+            double chi = chi_square(counts, std::vector<double>(16, 1.0 / 16), total);
+            return {"poker (4-bit)", chi, igamc(15 / 2.0, chi / 2)};
+        }
+
+    private:
+        std::vector<uint64_t> counts = std::vector<uint64_t>(16, 0);
+        uint64_t total = 0;
+};
+
+/// @brief Сериальный тест: пары соседних чисел (старшие 4 бита каждого) по 256 клеткам
+class SerialTest : public BatteryTest {
+    public:
+        using BatteryTest::BatteryTest;
+
+        void consume(std::span<const uint32_t> block) override {
+            for (uint32_t value : block) {
+                uint32_t top = (value >> (bits - 4)) & 15;
+                if (has_first) {
+                    counts[(first << 4) | top]++;
+                    pairs++;
+                }
+                else first = top;
+                has_first = !has_first;
+            }
+        }
+
+        TestResult result() const override {
+            double chi = chi_square(counts, std::vector<double>(256, 1.0 / 256), pairs);
+            return {"serial (pairs)", chi, igamc(255 / 2.0, chi / 2)};
+        }
+
+    private:
+        std::vector<uint64_t> counts = std::vector<uint64_t>(256, 0);
+        uint64_t pairs = 0;
+        uint32_t first = 0;
+        bool has_first = false;
+};
+
+/// @brief Автокорреляция соседних чисел (лаг 1), числа приведены к [0, 1)
+class AutocorrelationTest : public BatteryTest {
+    public:
+        using BatteryTest::BatteryTest;
+
+        void consume(std::span<const uint32_t> block) override {
+            const double scale = std::ldexp(1.0, -bits);
+            for (uint32_t value : block) {
+                double u = value * scale - 0.5;
+                if (count > 0) sum += previous * u;
+                previous = u;
+                count++;
+            }
+        }
+
+        TestResult result() const override {
+            // Для независимых равномерных E[(u-1/2)(v-1/2)] = 0, дисперсия слагаемого 1/144
+            double n = double(count > 0 ? count - 1 : 0);
+            double z = n > 0 ? sum * 12 / std::sqrt(n) : 0;
+            return {"autocorrelation (lag 1)", z, normal_p_value(z)};
+        }
+
+    private:
+        double sum = 0, previous = 0;
+        uint64_t count = 0;
+};
+
+/// @brief Тест дней рождения (Марсалья): m чисел как дни в году из 2^bits дней,
+/// число совпадающих расстояний между соседними днями ~ Пуассон(m^3 / (4 * 2^bits))
+class BirthdaySpacingsTest : public BatteryTest {
+    public:
+        explicit BirthdaySpacingsTest(int bits) : BatteryTest(bits) {
+            double days = std::ldexp(1.0, bits);
+            birthdays = std::max(8, static_cast<int>(std::round(std::cbrt(8 * days)))); // lambda около 2
+            lambda = std::pow(double(birthdays), 3) / (4 * days);
+            sample.reserve(birthdays);
+        }
+
+        void consume(std::span<const uint32_t> block) override {
+            for (uint32_t value : block) {
+                sample.push_back(value);
+                if (static_cast<int>(sample.size()) == birthdays) {
+                    std::sort(sample.begin(), sample.end());
+                    // Год замкнут: расстояние от последнего дня до первого через конец года
+                    uint32_t wrap = static_cast<uint32_t>((uint64_t(1) << bits) + sample[0] - sample[birthdays - 1]);
+                    for (int i = birthdays - 1; i > 0; i--) sample[i] -= sample[i - 1];
+                    sample[0] = wrap;
+                    std::sort(sample.begin(), sample.end());
+                    for (int i = 1; i < birthdays; i++) duplicates += sample[i] == sample[i - 1];
+                    samples++;
+                    sample.clear();
+                }
+            }
+        }
+
+        TestResult result() const override {
+            // Сумма независимых пуассоновских величин - Пуассон(lambda * samples), нормальное приближение
+            double expected = lambda * samples;
+            double z = expected > 0 ? (duplicates - expected) / std::sqrt(expected) : 0;
+            return {"birthday spacings", double(duplicates), normal_p_value(z)};
+        }
+
+    private:
+        int birthdays;
+        double lambda;
+        std::vector<uint32_t> sample;
+        uint64_t duplicates = 0, samples = 0;
+};
+
+/// @brief Тест интервалов (Кнут): длины промежутков между числами из нижней половины диапазона
+class GapTest : public BatteryTest {
+    public:
+        using BatteryTest::BatteryTest;
+
+        void consume(std::span<const uint32_t> block) override {
+            for (uint32_t value : block) {
+                if ((value >> (bits - 1)) & 1) {
+                    gap++;
+                    continue;
+                }
+                counts[std::min(gap, max_gap)]++;
+                gaps++;
+                gap = 0;
+            }
+        }
+
+        TestResult result() const override {
+            // P(длина r) = (1/2)^(r+1) при r < max_gap, хвост (1/2)^max_gap
+            std::vector<double> probability(max_gap + 1);
+            for (uint64_t r = 0; r < max_gap; r++) probability[r] = std::ldexp(1.0, -int(r + 1));
+            probability[max_gap] = std::ldexp(1.0, -int(max_gap));
+            double chi = chi_square(counts, probability, gaps);
+            return {"gap", chi, igamc(max_gap / 2.0, chi / 2)};
+        }
+
+    private:
+        static const uint64_t max_gap = 16;
+        std::vector<uint64_t> counts = std::vector<uint64_t>(max_gap + 1, 0);
+        uint64_t gap = 0, gaps = 0;
+};
+
+/// @brief Стандартный набор тестов
+/// @param bits Число значащих бит в числах генератора (4..32)
+inline std::vector<std::unique_ptr<BatteryTest>> default_battery(int bits) {
+    if (bits < 4 || bits > 32) throw std::invalid_argument("battery needs 4..32 bit numbers");
+    std::vector<std::unique_ptr<BatteryTest>> tests;
+    tests.push_back(std::make_unique<MonobitTest>(bits));
+    tests.push_back(std::make_unique<BlockFrequencyTest>(bits));
+    tests.push_back(std::make_unique<RunsTest>(bits));
+    tests.push_back(std::make_unique<PokerTest>(bits));
+    tests.push_back(std::make_unique<SerialTest>(bits));
+    tests.push_back(std::make_unique<AutocorrelationTest>(bits));
+    tests.push_back(std::make_unique<BirthdaySpacingsTest>(bits));
+    tests.push_back(std::make_unique<GapTest>(bits));
+    return tests;
+}
+
+/// @brief Прогон набора тестов по count числам генератора
+/// @param generator Любой генератор с fill(std::span<uint32_t>)
+/// @param bits Число значащих бит в числах генератора
+/// @param threads Число потоков с тестами (генератор работает в вызывающем потоке)
+/// @param block Размер общего блока
+template <class Generator>
+std::vector<TestResult> run_battery(Generator& generator, uint64_t count, int bits,
+                                    unsigned int threads = std::max(1u, std::thread::hardware_concurrency()),
+                                    size_t block = 1 << 16) {
+    std::vector<std::unique_ptr<BatteryTest>> tests = default_battery(bits);
+    threads = std::max(1u, std::min<unsigned int>(threads, tests.size()));
+
+    // Двойной буфер: пока тесты читают buffers[k % 2], генератор пишет buffers[(k + 1) % 2]
+    std::vector<uint32_t> buffers[2] = {std::vector<uint32_t>(block), std::vector<uint32_t>(block)};
+    size_t sizes[2] = {0, 0};
+    auto next_block = [&](int b) {
+        sizes[b] = static_cast<size_t>(std::min<uint64_t>(count, block));
+        generator.fill(std::span<uint32_t>(buffers[b].data(), sizes[b]));
+        count -= sizes[b];
+    };
+    next_block(0);
+
+    std::barrier sync(threads + 1);
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            for (int k = 0; sizes[k % 2] > 0; k++) {
+                std::span<const uint32_t> data(buffers[k % 2].data(), sizes[k % 2]);
+                for (size_t i = t; i < tests.size(); i += threads) tests[i]->consume(data);
+                sync.arrive_and_wait();
+            }
+        });
+    }
+    for (int k = 0; sizes[k % 2] > 0; k++) {
+        next_block((k + 1) % 2); // 0 чисел - сигнал потокам закончить
+        sync.arrive_and_wait();
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    std::vector<TestResult> results;
+    for (const auto& test : tests) results.push_back(test->result());
+    return results;
+}
@@ -0,0 +1,285 @@
+#include <vector>
+#include <string>
+#include <span>
+#include <memory>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <iostream>
+#include <charconv>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+
+/// @file writers.h
+/// @brief Вывод чисел: упаковка в 24 бита, текст через std::to_chars, асинхронная запись
+///
+/// AsyncWriter держит два выровненных буфера: пока поток записи отдает один в write(2),
+/// вызывающий поток заполняет второй, поэтому генерация и ввод-вывод идут одновременно.
+/// stream_raw() пишет непрерывный поток байт без разделителей (формат -g 200 у dieharder).
+/// Подключается после generators.h.
+
+/// @brief Упаковка младших 24 бит каждого числа, старший байт первым
+/// @return Число записанных байт (3 на число)
+inline size_t encode_24bit(std::span<const uint32_t> numbers, char* out) {
+    char* p = out;
+    for (uint32_t num : numbers) {
+        p[0] = static_cast<char>(num >> 16);
+        p[1] = static_cast<char>(num >> 8);
+        p[2] = static_cast<char>(num);
+        p += 3;
+    }
+    return p - out;
+}
+
+/// @brief Упаковка младших bytes байт каждого числа, старший байт первым
+inline size_t encode_packed(std::span<const uint32_t> numbers, int bytes, char* out) {
+    if (bytes == 3) return encode_24bit(numbers, out);
+    char* p = out;
+    for (uint32_t num : numbers)
+        for (int b = bytes - 1; b >= 0; b--) *p++ = static_cast<char>(num >> (8 * b));
+    return p - out;
+}
+
+/// @brief Упаковка младших bits бит каждого числа вплотную, старший бит первым
+///
+/// Для чисел, у которых значащих бит не кратно 8 (LCG: 13-14), в поток не попадают нулевые
+/// старшие биты. Неполный последний байт переносится в следующий вызов encode().
+struct BitPacker {
+    int bits;
+    uint64_t pending = 0;
+    int pending_bits = 0;
+
+    explicit BitPacker(int bits) : bits(bits) {}
+
+    /// @param out Не меньше (bits * numbers.size() + 7) / 8 + 1 байт
+    size_t encode(std::span<const uint32_t> numbers, char* out) {
+        const uint64_t mask = (uint64_t(1) << bits) - 1;
+        char* p = out;
+        for (uint32_t num : numbers) {
+            pending = (pending << bits) | (num & mask); // старше pending_bits - уже выданные биты
+            pending_bits += bits;
+            while (pending_bits >= 8) {
+                pending_bits -= 8;
+                *p++ = static_cast<char>(pending >> pending_bits);
+            }
+        }
+        return p - out;
+    }
+
+    /// @brief Остаток неполного байта, дополненный нулями справа
+    size_t finish(char* out) {
+        if (pending_bits == 0) return 0;
+        *out = static_cast<char>(pending << (8 - pending_bits));
+        pending_bits = 0;
+        return 1;
+    }
+};
+
+/// @brief Числа в десятичном виде, по одному на строку
+/// @param out Не меньше 11 байт на число
+inline size_t encode_text(std::span<const uint32_t> numbers, char* out) {
+    char* p = out;
+    for (uint32_t num : numbers) {
+        p = std::to_chars(p, p + 10, num).ptr;
+        *p++ = '\n';
+    }
+    return p - out;
+}
+
+/// @brief Запись в файловый дескриптор через два буфера и отдельный поток
+class AsyncWriter {
+    public:
+        /// @brief Выравнивание буферов (страница)
+        static const size_t alignment = 4096;
+
+        /// @param fd Открытый дескриптор; закрывается в деструкторе, если own_fd
+        /// @param buffer_size Размер каждого из двух буферов
+        explicit AsyncWriter(int fd, size_t buffer_size = 1 << 20, bool own_fd = true)
+            : fd(fd), own_fd(own_fd), capacity((buffer_size + alignment - 1) / alignment * alignment) {
+            for (auto& buffer : buffers) {
+                buffer.reset(static_cast<char*>(std::aligned_alloc(alignment, capacity)));
+                if (!buffer) {
+                    // Деструктор не вызовется: свой дескриптор закрываем здесь, буферы освободит unique_ptr
+                    if (own_fd && fd >= 0) close(fd);
+                    throw std::bad_alloc();
+                }
+            }
+            writer = std::thread([this] { write_loop(); });
+        }
+
+        AsyncWriter(const AsyncWriter&) = delete;
+        AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+        ~AsyncWriter() {
+            flush();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            ready.notify_all();
+            writer.join();
+            if (own_fd && fd >= 0) close(fd);
+        }
+
+        /// @brief Место под n байт (n <= размера буфера) в текущем буфере; после записи - commit(n)
+        char* reserve(size_t n) {
+            if (used + n > capacity) hand_over();
+            return buffers[current].get() + used;
+        }
+
+        void commit(size_t n) { used += n; }
+
+        /// @brief Копирование данных в буфер
+        void write(const char* data, size_t n) {
+            while (n > 0) {
+                size_t part = std::min(n, capacity - used);
+                if (part == 0) {
+                    hand_over();
+                    continue;
+                }
+                std::copy(data, data + part, buffers[current].get() + used);
+                used += part;
+                data += part;
+                n -= part;
+            }
+        }
+
+        /// @brief Отправка текущего буфера и ожидание конца записи
+        void flush() {
+            if (used > 0) hand_over();
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this] { return pending_size == 0; });
+        }
+
+        /// @brief False, если запись завершилась ошибкой (например, читатель закрыл канал)
+        bool ok() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return !failed;
+        }
+
+        size_t buffer_size() const { return capacity; }
+
+    private:
+        struct FreeDeleter {
+            void operator()(char* p) const { std::free(p); }
+        };
+
+        int fd;
+        bool own_fd;
+        size_t capacity;
+        std::unique_ptr<char, FreeDeleter> buffers[2];
+        /// @brief Буфер, который заполняет вызывающий поток
+        int current = 0;
+        size_t used = 0;
+
+        std::thread writer;
+        std::mutex mutex;
+        std::condition_variable ready, done;
+        /// @brief Буфер, переданный потоку записи, и его размер (0 - поток свободен)
+        const char* pending = nullptr;
+        size_t pending_size = 0;
+        bool stop = false;
+        bool failed = false;
+
+        /// @brief Передача текущего буфера потоку записи; ждет, пока тот освободится
+        void hand_over() {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this] { return pending_size == 0; });
+            pending = buffers[current].get();
+            pending_size = used;
+            lock.unlock();
+            ready.notify_one();
+            current ^= 1;
+            used = 0;
+        }
+
+        void write_loop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                ready.wait(lock, [this] { return pending_size > 0 || stop; });
+                if (pending_size == 0) return;
+                const char* data = pending;
+                size_t size = pending_size;
+                bool ok = !failed;
+                lock.unlock();
+                while (ok && size > 0) {
+                    ssize_t w = ::write(fd, data, size);
+                    if (w < 0 && errno == EINTR) continue;
+                    if (w <= 0) ok = false;
+                    else {
+                        data += w;
+                        size -= w;
+                    }
+                }
+                lock.lock();
+                failed = !ok;
+                pending_size = 0;
+                done.notify_all();
+            }
+        }
+};
+
+/// @brief Открытие файла на запись; -1 и сообщение в std::cerr при ошибке
+inline int open_output(const std::string& filename) {
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) std::cerr << "Не удалось открыть файл " << filename << " для записи." << std::endl;
+    return fd;
+}
+
+/// @brief Запись в файл сгенерированных чисел
+/// @param filename Имя файла записи
+/// @param numbers Массив данных
+void write_numbers_file(const std::string& filename, const std::vector<unsigned int>& numbers) {
+    int fd = open_output(filename);
+    if (fd < 0) return;
+    AsyncWriter out(fd);
+    const size_t chunk = out.buffer_size() / 11;
+    for (size_t i = 0; i < numbers.size(); i += chunk) {
+        std::span<const uint32_t> part(numbers.data() + i, std::min(chunk, numbers.size() - i));
+        out.commit(encode_text(part, out.reserve(11 * part.size())));
+    }
+}
+
+/// @brief Запись в файл чисел в бинарном представлении (3 байта на число, старший первым)
+/// @param filename Имя файла записи
+/// @param result Массив данных
+void write_bin_file(const std::string& filename, const std::vector<unsigned int>& result) {
+    int fd = open_output(filename);
+    if (fd < 0) return;
+    AsyncWriter out(fd);
+    const size_t chunk = out.buffer_size() / 3;
+    for (size_t i = 0; i < result.size(); i += chunk) {
+        std::span<const uint32_t> part(result.data() + i, std::min(chunk, result.size() - i));
+        out.commit(encode_24bit(part, out.reserve(3 * part.size())));
+    }
+}
+
+/// @brief Непрерывный поток байт генератора в fd (stdout или FIFO) для dieharder -g 200
+/// @param bits Значащих бит в числе; при bits, кратном 8, пишется bits / 8 байт на число,
+/// иначе биты чисел идут вплотную (BitPacker), без нулевых старших бит
+/// @param count Сколько чисел записать; 0 - пока читатель не закроет поток
+/// @return False, если запись прервалась раньше count чисел
+template <class Generator>
+bool stream_raw(Generator& generator, int bits, int fd, uint64_t count = 0) {
+    const int bytes = (bits + 7) / 8;
+    AsyncWriter out(fd, 1 << 20, false);
+    std::vector<uint32_t> block(out.buffer_size() / 4 / bytes);
+    BitPacker packer(bits);
+    bool unbounded = count == 0;
+    while ((unbounded || count > 0) && out.ok()) {
+        size_t n = unbounded ? block.size() : static_cast<size_t>(std::min<uint64_t>(count, block.size()));
+        std::span<uint32_t> part(block.data(), n);
+        generator.fill(part);
+        if (bits % 8 == 0) out.commit(encode_packed(part, bytes, out.reserve(size_t(bytes) * n)));
+        else out.commit(packer.encode(part, out.reserve(size_t(bytes) * n + 1)));
+        if (!unbounded) count -= n;
+    }
+    if (out.ok()) out.commit(packer.finish(out.reserve(1)));
+    out.flush();
+    return out.ok() && count == 0;
+}